@@ -0,0 +1,325 @@
+/**
+ * @file frozen_ini.cpp
+ * @brief Implementation of the minimal perfect hash behind FrozenIni.
+ * @details Hash-and-displace construction, slot mapping and lookups.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frozen_ini.hpp"
+#include "ini_file.hpp"
+#include "ini_hash.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief Largest arena offset or entry count an Entry can hold.
+     */
+    constexpr size_t max_size = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Mixes a hash with a displacement (MurmurHash3 finalizer).
+     */
+    inline uint64_t mix(uint64_t hash, uint32_t displacement)
+    {
+        uint64_t h = hash ^ (displacement * 0x9e3779b97f4a7c15ull);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /**
+     * @brief Maps 32 hash bits onto [0, range) with a multiply instead of a divide.
+     */
+    inline size_t reduce(uint32_t bits, size_t range)
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(bits) * range) >> 32);
+    }
+}
+
+/**
+ * @brief Builds the table from the entries of a key table.
+ * @details Buckets are placed largest first, trying displacements from zero
+ *          until every entry of the bucket lands on a free slot. Section
+ *          names are stored once and shared by their entries.
+ * @param table The entries to freeze; later changes to it are not seen.
+ * @throws std::runtime_error if the data is too large to freeze, or if two
+ *         keys share a 64-bit hash.
+ */
+FrozenIni::FrozenIni(const IniTable &table)
+    : _fold(table.folds_case())
+{
+    const size_t count = table.size();
+    if (count == 0)
+    {
+        return;
+    }
+    if (count >= max_size)
+    {
+        throw std::runtime_error("Too many keys to freeze.");
+    }
+
+    // Copy the strings, one section name per section
+    std::vector<Entry> entries;
+    entries.reserve(count);
+    for (size_t s = 0; s < table.section_count(); ++s)
+    {
+        const std::string_view name = table.section_name(s);
+        const uint32_t name_offset = store(name);
+        for (size_t i = table.section_first(s); i != IniTable::npos; i = table.next_in_section(i))
+        {
+            Entry entry{};
+            entry.hash = table.hash(name, table.key(i));
+            entry.section = name_offset;
+            entry.section_length = static_cast<uint32_t>(name.size());
+            entry.key_length = static_cast<uint32_t>(table.key(i).size());
+            entry.key = store(table.key(i));
+            entry.value_length = static_cast<uint32_t>(table.value(i).size());
+            entry.value = store(table.value(i));
+            entries.push_back(entry);
+        }
+    }
+
+    // Keys with the same full hash can never be told apart by displacement
+    std::vector<uint64_t> hashes(count);
+    std::transform(entries.begin(), entries.end(), hashes.begin(), [](const Entry &entry)
+                   { return entry.hash; });
+    std::sort(hashes.begin(), hashes.end());
+    if (std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end())
+    {
+        throw std::runtime_error("Duplicate key hash; cannot freeze ini data.");
+    }
+
+    _entries.resize(count);
+    _displacements.assign(count / 2 + 1, 0);
+
+    // Group entries by bucket
+    const size_t buckets = _displacements.size();
+    std::vector<uint32_t> start(buckets + 1, 0);
+    for (const Entry &entry : entries)
+    {
+        ++start[bucket(entry.hash) + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<uint32_t> members(count);
+    std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        members[cursor[bucket(entries[i].hash)]++] = static_cast<uint32_t>(i);
+    }
+
+    std::vector<uint32_t> order(buckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&start](uint32_t a, uint32_t b)
+                     { return start[a + 1] - start[a] > start[b + 1] - start[b]; });
+
+    // Place buckets, largest first
+    std::vector<bool> taken(count, false);
+    std::vector<size_t> placed;
+    for (uint32_t b : order)
+    {
+        const uint32_t first = start[b];
+        const uint32_t last = start[b + 1];
+        if (first == last)
+        {
+            break;
+        }
+
+        for (uint32_t displacement = 0;; ++displacement)
+        {
+            if (displacement == std::numeric_limits<uint32_t>::max())
+            {
+                throw std::runtime_error("Cannot build perfect hash for ini data.");
+            }
+
+            placed.clear();
+            for (uint32_t m = first; m < last; ++m)
+            {
+                const size_t target = slot(entries[members[m]].hash, displacement);
+                if (taken[target])
+                {
+                    break;
+                }
+                taken[target] = true;
+                placed.push_back(target);
+            }
+
+            if (placed.size() == last - first)
+            {
+                _displacements[b] = displacement;
+                for (size_t j = 0; j < placed.size(); ++j)
+                {
+                    _entries[placed[j]] = entries[members[first + j]];
+                }
+                break;
+            }
+            for (size_t target : placed)
+            {
+                taken[target] = false;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Number of entries.
+ */
+size_t FrozenIni::size() const
+{
+    return _entries.size();
+}
+
+/**
+ * @brief Maps a hash to its bucket.
+ * @details FNV-1a leaves the high bits of short keys poorly mixed, so the
+ *          hash is finalized first; its high half picks the bucket and the
+ *          low half of the displaced mixes picks the slot.
+ */
+size_t FrozenIni::bucket(uint64_t hash) const
+{
+    return reduce(static_cast<uint32_t>(mix(hash, 0) >> 32), _displacements.size());
+}
+
+/**
+ * @brief Maps a hash and displacement to a slot.
+ */
+size_t FrozenIni::slot(uint64_t hash, uint32_t displacement) const
+{
+    return reduce(static_cast<uint32_t>(mix(hash, displacement)), _entries.size());
+}
+
+/**
+ * @brief Appends bytes to the arena and returns their offset.
+ * @throws std::runtime_error once the arena outgrows 32-bit offsets.
+ */
+uint32_t FrozenIni::store(std::string_view bytes)
+{
+    if (_arena.size() + bytes.size() >= max_size)
+    {
+        throw std::runtime_error("Ini data too large to freeze.");
+    }
+    const size_t offset = _arena.size();
+    _arena.append(bytes.data(), bytes.size());
+    return static_cast<uint32_t>(offset);
+}
+
+/**
+ * @brief Looks up a value.
+ * @details One hash, one displacement read, and one entry compare.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value Receives a view of the value if found.
+ * @return True if the key exists.
+ */
+bool FrozenIni::find(std::string_view section, std::string_view key, std::string_view &value) const
+{
+    if (_entries.empty())
+    {
+        return false;
+    }
+
+    const uint64_t hash = IniHash::key(section, key, _fold);
+    const Entry &entry = _entries[slot(hash, _displacements[bucket(hash)])];
+    if (entry.hash != hash ||
+        !IniHash::equal(std::string_view(_arena.data() + entry.key, entry.key_length), key, _fold) ||
+        !IniHash::equal(std::string_view(_arena.data() + entry.section, entry.section_length), section, _fold))
+    {
+        return false;
+    }
+    value = std::string_view(_arena.data() + entry.value, entry.value_length);
+    return true;
+}
+
+/**
+ * @brief Retrieves a value.
+ * @param section The section name.
+ * @param key The key name.
+ * @return A view of the value, valid for the lifetime of the table.
+ * @throws std::runtime_error if the key is not found.
+ */
+std::string_view FrozenIni::get_value(std::string_view section, std::string_view key) const
+{
+    std::string_view value;
+    if (!find(section, key, value))
+    {
+        throw std::runtime_error("Error retrieving '" + std::string(key) + "' from section [" + std::string(section) + "].");
+    }
+    return value;
+}
+
+/**
+ * @brief Retrieves a string value.
+ * @param section The section name.
+ * @param key The key name.
+ * @return A copy of the stored value.
+ * @throws std::runtime_error if the key is not found.
+ */
+std::string FrozenIni::get_string_value(std::string_view section, std::string_view key) const
+{
+    return std::string(get_value(section, key));
+}
+
+/**
+ * @brief Retrieves a boolean value.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The boolean representation of the stored value.
+ * @throws std::runtime_error if the key is not found.
+ */
+bool FrozenIni::get_bool_value(std::string_view section, std::string_view key) const
+{
+    return IniFile::string_to_bool(get_value(section, key));
+}
+
+/**
+ * @brief Retrieves an integer value.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The integer representation of the stored value.
+ * @throws std::runtime_error if the key is not found or is not a valid integer.
+ */
+int FrozenIni::get_int_value(std::string_view section, std::string_view key) const
+{
+    return IniFile::to_int(std::string(get_value(section, key)), section, key);
+}
+
+/**
+ * @brief Retrieves a double value.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The double representation of the stored value.
+ * @throws std::runtime_error if the key is not found or is not a valid double.
+ */
+double FrozenIni::get_double_value(std::string_view section, std::string_view key) const
+{
+    return IniFile::to_double(std::string(get_value(section, key)), section, key);
+}
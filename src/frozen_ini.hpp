@@ -0,0 +1,157 @@
+/**
+ * @file frozen_ini.hpp
+ * @brief Immutable INI lookup table built on a minimal perfect hash.
+ * @details A FrozenIni is a read-only copy of the values of an IniFile,
+ *          indexed so that every lookup costs one hash and one compare.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FROZEN_INI_HPP
+#define FROZEN_INI_HPP
+
+#include "ini_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class FrozenIni
+ * @brief Read-only section/key/value table with one probe per lookup.
+ * @details Built once with hash-and-displace (CHD): entry hashes are split
+ *          into buckets of about two, and each bucket, largest first, is
+ *          given the smallest displacement that sends all of its entries to
+ *          free slots. The result is a minimal perfect hash: n entries fill
+ *          exactly n slots, and a key can only ever live in one of them. A
+ *          lookup hashes the section and key once, reads the bucket's
+ *          displacement, and compares the one entry it lands on.
+ *
+ *          All strings are copied into one arena, so the table does not
+ *          depend on the IniFile it came from and views returned by it stay
+ *          valid for its lifetime. Names ignore ASCII case if the source
+ *          table folds case.
+ */
+class FrozenIni
+{
+public:
+    /**
+     * @brief Constructs an empty table.
+     */
+    FrozenIni() = default;
+
+    /**
+     * @brief Builds the table from the entries of a key table.
+     * @param table The entries to freeze; later changes to it are not seen.
+     * @throws std::runtime_error if the data is too large to freeze.
+     */
+    explicit FrozenIni(const IniTable &table);
+
+    /**
+     * @brief Number of entries.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Looks up a value.
+     * @param section The section name.
+     * @param key The key name.
+     * @param value Receives a view of the value if found.
+     * @return True if the key exists.
+     */
+    bool find(std::string_view section, std::string_view key, std::string_view &value) const;
+
+    /**
+     * @brief Retrieves a value.
+     * @param section The section name.
+     * @param key The key name.
+     * @return A view of the value, valid for the lifetime of the table.
+     * @throws std::runtime_error if the key is not found.
+     */
+    std::string_view get_value(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Retrieves a string value.
+     */
+    std::string get_string_value(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Retrieves a boolean value.
+     */
+    bool get_bool_value(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Retrieves an integer value.
+     */
+    int get_int_value(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Retrieves a double value.
+     */
+    double get_double_value(std::string_view section, std::string_view key) const;
+
+private:
+    /**
+     * @brief One key/value pair, stored in the slot the hash assigns it.
+     */
+    struct Entry
+    {
+        uint64_t hash;           ///< IniHash::key() of section and key, folded like _fold.
+        uint32_t section;        ///< Arena offset of the section name.
+        uint32_t section_length; ///< Length of the section name.
+        uint32_t key;            ///< Arena offset of the key.
+        uint32_t key_length;     ///< Length of the key.
+        uint32_t value;          ///< Arena offset of the value.
+        uint32_t value_length;   ///< Length of the value.
+    };
+
+    /**
+     * @brief Maps a hash to its bucket.
+     */
+    size_t bucket(uint64_t hash) const;
+
+    /**
+     * @brief Maps a hash and displacement to a slot.
+     */
+    size_t slot(uint64_t hash, uint32_t displacement) const;
+
+    /**
+     * @brief Appends bytes to the arena and returns their offset.
+     */
+    uint32_t store(std::string_view bytes);
+
+    std::string _arena;                   ///< Section names, keys and values.
+    std::vector<Entry> _entries;          ///< Entries, indexed by slot.
+    std::vector<uint32_t> _displacements; ///< Displacement per bucket.
+    bool _fold = false;                   ///< True to ignore ASCII case in names.
+};
+
+/**
+ * @brief Immutable configuration published by IniFile::snapshot().
+ */
+using ConfigSnapshot = FrozenIni;
+
+#endif // FROZEN_INI_HPP
@@ -0,0 +1,234 @@
+/**
+ * @file ini_binding.hpp
+ * @brief Compile-time field tables for reading a whole struct at once.
+ * @details IniField describes one member of a struct: its section, its
+ *          key, its type and where it lives. A table of them, declared once
+ *          in an IniBinding specialization, lets bind() fill the struct in
+ *          one pass over its sections.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_BINDING_HPP
+#define INI_BINDING_HPP
+
+#include "ini_hash.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Value types a field can be read as.
+ */
+enum class IniFieldType
+{
+    Bool,   ///< Read like get_bool_value().
+    Int,    ///< Read like get_int_value().
+    Double, ///< Read like get_double_value().
+    String  ///< Read like get_string_value().
+};
+
+/**
+ * @struct IniBoundField
+ * @brief One field of a table applied to a particular object.
+ * @details Built by bind() and handed to IniFile::bind(), which needs no
+ *          knowledge of the struct's type.
+ */
+struct IniBoundField
+{
+    std::string_view section; ///< Section name.
+    std::string_view key;     ///< Key name.
+    uint64_t hash;            ///< IniHash::key() of section and key.
+    uint64_t folded_hash;     ///< The same hash with case folded.
+    IniFieldType type;        ///< How the value is converted.
+    void *target;             ///< The member to fill; its type matches type.
+};
+
+/**
+ * @class IniField
+ * @brief Describes where one member of T is read from.
+ * @details Fields are literal types, so a whole table is built at compile
+ *          time, hashes included, and reading it costs no hashing of names.
+ * @tparam T The struct the field belongs to.
+ */
+template <typename T>
+class IniField
+{
+public:
+    /**
+     * @brief Describes a boolean member.
+     */
+    constexpr IniField(std::string_view section, std::string_view key, bool T::*member)
+        : IniField(section, key, IniFieldType::Bool, Member(member))
+    {
+    }
+
+    /**
+     * @brief Describes an integer member.
+     */
+    constexpr IniField(std::string_view section, std::string_view key, int T::*member)
+        : IniField(section, key, IniFieldType::Int, Member(member))
+    {
+    }
+
+    /**
+     * @brief Describes a double member.
+     */
+    constexpr IniField(std::string_view section, std::string_view key, double T::*member)
+        : IniField(section, key, IniFieldType::Double, Member(member))
+    {
+    }
+
+    /**
+     * @brief Describes a string member.
+     */
+    constexpr IniField(std::string_view section, std::string_view key, std::string T::*member)
+        : IniField(section, key, IniFieldType::String, Member(member))
+    {
+    }
+
+    /**
+     * @brief Section name.
+     */
+    constexpr std::string_view section() const { return _section; }
+
+    /**
+     * @brief Key name.
+     */
+    constexpr std::string_view key() const { return _key; }
+
+    /**
+     * @brief Applies the field to an object.
+     * @param object The struct to fill.
+     * @return The field with its member resolved to an address in object.
+     */
+    IniBoundField on(T &object) const
+    {
+        IniBoundField bound{_section, _key, _hash, _folded_hash, _type, nullptr};
+        switch (_type)
+        {
+        case IniFieldType::Bool:
+            bound.target = &(object.*_member.as_bool);
+            break;
+        case IniFieldType::Int:
+            bound.target = &(object.*_member.as_int);
+            break;
+        case IniFieldType::Double:
+            bound.target = &(object.*_member.as_double);
+            break;
+        case IniFieldType::String:
+            bound.target = &(object.*_member.as_string);
+            break;
+        }
+        return bound;
+    }
+
+    /**
+     * @brief Orders a table so that fields of one section are adjacent.
+     * @details Sections keep the order of their first field, and fields
+     *          keep their order within a section.
+     * @param fields The table.
+     * @return Field indices in section order.
+     */
+    template <size_t N>
+    static constexpr std::array<size_t, N> section_order(const IniField (&fields)[N])
+    {
+        std::array<size_t, N> order{};
+        std::array<bool, N> placed{};
+        size_t next = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (placed[i])
+            {
+                continue;
+            }
+            for (size_t j = i; j < N; ++j)
+            {
+                if (!placed[j] && fields[j]._section == fields[i]._section)
+                {
+                    placed[j] = true;
+                    order[next++] = j;
+                }
+            }
+        }
+        return order;
+    }
+
+private:
+    /**
+     * @brief The member pointer, of the kind named by _type.
+     */
+    union Member
+    {
+        constexpr explicit Member(bool T::*member) : as_bool(member) {}
+        constexpr explicit Member(int T::*member) : as_int(member) {}
+        constexpr explicit Member(double T::*member) : as_double(member) {}
+        constexpr explicit Member(std::string T::*member) : as_string(member) {}
+
+        bool T::*as_bool;          ///< Set for IniFieldType::Bool.
+        int T::*as_int;            ///< Set for IniFieldType::Int.
+        double T::*as_double;      ///< Set for IniFieldType::Double.
+        std::string T::*as_string; ///< Set for IniFieldType::String.
+    };
+
+    /**
+     * @brief Stores the names, both hashes and the member.
+     */
+    constexpr IniField(std::string_view section, std::string_view key, IniFieldType type, Member member)
+        : _section(section), _key(key), _hash(IniHash::key(section, key)),
+          _folded_hash(IniHash::key(section, key, true)), _type(type), _member(member)
+    {
+    }
+
+    std::string_view _section; ///< Section name.
+    std::string_view _key;     ///< Key name.
+    uint64_t _hash;            ///< IniHash::key() of section and key.
+    uint64_t _folded_hash;     ///< The same hash with case folded.
+    IniFieldType _type;        ///< Which member pointer is set.
+    Member _member;            ///< Pointer to the member.
+};
+
+/**
+ * @brief Field table of a struct, to be specialized next to the struct.
+ * @details A specialization provides a static constexpr array of
+ *          IniField<T> named fields:
+ * @code
+ * template <>
+ * struct IniBinding<Settings>
+ * {
+ *     static constexpr IniField<Settings> fields[] = {
+ *         {"Common", "TX Power", &Settings::power},
+ *         {"Server", "Web Port", &Settings::web_port},
+ *     };
+ * };
+ * @endcode
+ * @tparam T The described struct.
+ */
+template <typename T>
+struct IniBinding;
+
+#endif // INI_BINDING_HPP
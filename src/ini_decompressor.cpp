@@ -0,0 +1,433 @@
+/**
+ * @file ini_decompressor.cpp
+ * @brief Implementation of streaming gzip and zstd decompression.
+ * @details Wraps zlib's inflate() and zstd's streaming decoder behind one
+ *          block-at-a-time interface, plus one-shot compression for saving.
+ *          Each codec is only compiled in when the build provides it.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ini_decompressor.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#ifdef INI_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef INI_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Compares the start of a stream with a magic number.
+     * @param head The first bytes of the stream.
+     * @param magic The magic number.
+     * @param size Length of the magic number.
+     * @return 0 on a mismatch, 1 if head is a shorter prefix, 2 on a match.
+     */
+    int match_magic(std::string_view head, const unsigned char *magic, size_t size)
+    {
+        const size_t n = std::min(head.size(), size);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (static_cast<unsigned char>(head[i]) != magic[i])
+            {
+                return 0;
+            }
+        }
+        return (n < size) ? 1 : 2;
+    }
+}
+
+/**
+ * @brief Codec state and output block of a started stream.
+ */
+struct IniDecompressor::Stream
+{
+    std::string out = std::string(output_size, '\0'); ///< Output block.
+    bool ended = false;                                ///< At a member or frame boundary.
+#ifdef INI_HAVE_ZLIB
+    z_stream zlib{};      ///< gzip decoder.
+    bool zlib_ready = false; ///< True once inflateInit2() succeeded.
+#endif
+#ifdef INI_HAVE_ZSTD
+    ZSTD_DStream *zstd = nullptr; ///< zstd decoder.
+#endif
+
+    ~Stream()
+    {
+#ifdef INI_HAVE_ZLIB
+        if (zlib_ready)
+        {
+            inflateEnd(&zlib);
+        }
+#endif
+#ifdef INI_HAVE_ZSTD
+        ZSTD_freeDStream(zstd);
+#endif
+    }
+};
+
+IniDecompressor::IniDecompressor() = default;
+
+IniDecompressor::~IniDecompressor() = default;
+
+/**
+ * @brief Identifies the format from the start of a stream.
+ * @param head The first bytes of the stream.
+ * @return Unknown only if head is a short prefix of a magic number.
+ */
+IniDecompressor::Format IniDecompressor::detect(std::string_view head)
+{
+    static const unsigned char gzip_magic[] = {0x1f, 0x8b};
+    static const unsigned char zstd_magic[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+    const int gzip = match_magic(head, gzip_magic, sizeof(gzip_magic));
+    const int zstd = match_magic(head, zstd_magic, sizeof(zstd_magic));
+    if (gzip == 2)
+    {
+        return Format::Gzip;
+    }
+    if (zstd == 2)
+    {
+        return Format::Zstd;
+    }
+    return (gzip == 1 || zstd == 1) ? Format::Unknown : Format::Plain;
+}
+
+/**
+ * @brief Returns the format detected so far.
+ */
+IniDecompressor::Format IniDecompressor::format() const
+{
+    return _format;
+}
+
+/**
+ * @brief Decompresses the next bytes of input.
+ * @details Until the format is known, leading bytes are held back; this only
+ *          happens while fewer bytes than a magic number have arrived.
+ * @param input The next bytes of the stream.
+ * @param sink Receives the text produced.
+ * @return False if the sink asked to stop.
+ * @throws std::runtime_error if the data is corrupt or its codec is not built in.
+ */
+bool IniDecompressor::write(std::string_view input, const Sink &sink)
+{
+    if (_format != Format::Unknown)
+    {
+        return decode(input, sink);
+    }
+
+    if (_head.empty())
+    {
+        _format = detect(input);
+        if (_format != Format::Unknown)
+        {
+            start();
+            return decode(input, sink);
+        }
+    }
+
+    _head.append(input.data(), input.size());
+    _format = detect(_head);
+    if (_format == Format::Unknown)
+    {
+        return true;
+    }
+
+    start();
+    std::string head = std::move(_head);
+    _head.clear();
+    return decode(head, sink);
+}
+
+/**
+ * @brief Ends the stream and flushes any bytes held for detection.
+ * @param sink Receives the text produced.
+ * @return False if the sink asked to stop.
+ * @throws std::runtime_error if a compressed stream was cut short.
+ */
+bool IniDecompressor::finish(const Sink &sink)
+{
+    if (_format == Format::Unknown)
+    {
+        // Shorter than any magic number, so it can only be text
+        _format = Format::Plain;
+        return _head.empty() || sink(_head);
+    }
+    if (_stream && !_stream->ended)
+    {
+        throw std::runtime_error(std::string("Truncated ") + (_format == Format::Gzip ? "gzip" : "zstd") +
+                                 " data in ini source.");
+    }
+    return true;
+}
+
+/**
+ * @brief Starts the codec for the detected format.
+ * @throws std::runtime_error if the codec is not built in.
+ */
+void IniDecompressor::start()
+{
+    if (_format == Format::Gzip)
+    {
+#ifdef INI_HAVE_ZLIB
+        _stream.reset(new Stream());
+        // 15 + 16: largest window, gzip wrapper only
+        if (inflateInit2(&_stream->zlib, 15 + 16) != Z_OK)
+        {
+            throw std::runtime_error("Cannot start gzip decompression.");
+        }
+        _stream->zlib_ready = true;
+#else
+        throw std::runtime_error("Cannot read gzip-compressed ini data: built without zlib.");
+#endif
+    }
+    else if (_format == Format::Zstd)
+    {
+#ifdef INI_HAVE_ZSTD
+        _stream.reset(new Stream());
+        _stream->zstd = ZSTD_createDStream();
+        if (_stream->zstd == nullptr || ZSTD_isError(ZSTD_initDStream(_stream->zstd)))
+        {
+            throw std::runtime_error("Cannot start zstd decompression.");
+        }
+#else
+        throw std::runtime_error("Cannot read zstd-compressed ini data: built without zstd.");
+#endif
+    }
+}
+
+/**
+ * @brief Runs the codec over input.
+ * @details Concatenated gzip members and zstd frames are decoded in turn,
+ *          as the command-line tools do.
+ * @param input Compressed bytes.
+ * @param sink Receives the text produced.
+ * @return False if the sink asked to stop.
+ * @throws std::runtime_error if the data is corrupt.
+ */
+bool IniDecompressor::decode(std::string_view input, const Sink &sink)
+{
+    if (_format == Format::Plain)
+    {
+        return input.empty() || sink(input);
+    }
+
+    Stream &s = *_stream;
+#ifdef INI_HAVE_ZLIB
+    if (_format == Format::Gzip)
+    {
+        while (!input.empty())
+        {
+            if (s.ended)
+            {
+                inflateReset(&s.zlib);
+                s.ended = false;
+            }
+
+            // avail_in is only 32 bits wide
+            const size_t take = std::min(input.size(), size_t(1) << 30);
+            s.zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+            s.zlib.avail_in = static_cast<uInt>(take);
+            do
+            {
+                s.zlib.next_out = reinterpret_cast<Bytef *>(&s.out[0]);
+                s.zlib.avail_out = static_cast<uInt>(output_size);
+                const int ret = ::inflate(&s.zlib, Z_NO_FLUSH);
+                if (ret == Z_STREAM_END)
+                {
+                    s.ended = true;
+                }
+                else if (ret != Z_OK && ret != Z_BUF_ERROR)
+                {
+                    throw std::runtime_error("Corrupt gzip data in ini source.");
+                }
+
+                const size_t produced = output_size - s.zlib.avail_out;
+                if (produced > 0 && !sink(std::string_view(s.out.data(), produced)))
+                {
+                    return false;
+                }
+            } while (!s.ended && (s.zlib.avail_in > 0 || s.zlib.avail_out == 0));
+
+            input.remove_prefix(take - s.zlib.avail_in);
+        }
+        return true;
+    }
+#endif
+#ifdef INI_HAVE_ZSTD
+    if (_format == Format::Zstd)
+    {
+        ZSTD_inBuffer in{input.data(), input.size(), 0};
+        for (;;)
+        {
+            ZSTD_outBuffer out{&s.out[0], output_size, 0};
+            const size_t ret = ZSTD_decompressStream(s.zstd, &out, &in);
+            if (ZSTD_isError(ret))
+            {
+                throw std::runtime_error(std::string("Corrupt zstd data in ini source: ") +
+                                         ZSTD_getErrorName(ret) + ".");
+            }
+            s.ended = (ret == 0);
+
+            if (out.pos > 0 && !sink(std::string_view(s.out.data(), out.pos)))
+            {
+                return false;
+            }
+            if (in.pos == in.size && out.pos < out.size)
+            {
+                return true;
+            }
+        }
+    }
+#endif
+    (void)s;
+    return true;
+}
+
+/**
+ * @brief Guesses the decompressed size from the stream headers.
+ * @details gzip stores the size modulo 2^32 in its last four bytes; zstd
+ *          frames usually record it in their header. The result is only used
+ *          to reserve memory, so it is capped by the best possible ratio.
+ * @param bytes A complete compressed buffer.
+ * @return The expected size, or 0 if unknown.
+ */
+size_t IniDecompressor::content_size(std::string_view bytes)
+{
+    uint64_t size = 0;
+    switch (detect(bytes))
+    {
+    case Format::Gzip:
+        if (bytes.size() >= 18)
+        {
+            const unsigned char *tail = reinterpret_cast<const unsigned char *>(bytes.data() + bytes.size() - 4);
+            size = uint64_t(tail[0]) | uint64_t(tail[1]) << 8 | uint64_t(tail[2]) << 16 | uint64_t(tail[3]) << 24;
+        }
+        break;
+    case Format::Zstd:
+#ifdef INI_HAVE_ZSTD
+    {
+        const unsigned long long frame = ZSTD_getFrameContentSize(bytes.data(), bytes.size());
+        if (frame != ZSTD_CONTENTSIZE_UNKNOWN && frame != ZSTD_CONTENTSIZE_ERROR)
+        {
+            size = frame;
+        }
+    }
+#endif
+        break;
+    default:
+        return bytes.size();
+    }
+    return static_cast<size_t>(std::min<uint64_t>(size, uint64_t(bytes.size()) * 1032));
+}
+
+/**
+ * @brief Decompresses a complete buffer.
+ * @param bytes Compressed or plain data.
+ * @return The text, or a copy of bytes if they are plain.
+ * @throws std::runtime_error if the data is corrupt or its codec is not built in.
+ */
+std::string IniDecompressor::inflate(std::string_view bytes)
+{
+    std::string text;
+    text.reserve(content_size(bytes));
+
+    IniDecompressor decompressor;
+    const Sink append = [&text](std::string_view out)
+    {
+        text.append(out.data(), out.size());
+        return true;
+    };
+    decompressor.write(bytes, append);
+    decompressor.finish(append);
+    return text;
+}
+
+/**
+ * @brief Compresses text into a format that inflate() reads back.
+ * @details gzip output is a single member at zlib's default level; zstd
+ *          output is a single frame at zstd's default level.
+ * @param text The text to compress.
+ * @param format Gzip or Zstd; Plain returns a copy of text.
+ * @return The compressed bytes.
+ * @throws std::runtime_error if the codec is not built in or fails.
+ */
+std::string IniDecompressor::compress(std::string_view text, Format format)
+{
+    if (format == Format::Gzip)
+    {
+#ifdef INI_HAVE_ZLIB
+        // One deflate() call takes 32-bit sizes; leave room for the bound
+        if (text.size() > std::numeric_limits<uInt>::max() / 2)
+        {
+            throw std::runtime_error("Ini data too large to compress with gzip.");
+        }
+        z_stream zlib{};
+        if (deflateInit2(&zlib, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw std::runtime_error("Cannot start gzip compression.");
+        }
+        std::string bytes(deflateBound(&zlib, static_cast<uLong>(text.size())), '\0');
+        zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+        zlib.avail_in = static_cast<uInt>(text.size());
+        zlib.next_out = reinterpret_cast<Bytef *>(&bytes[0]);
+        zlib.avail_out = static_cast<uInt>(bytes.size());
+        const int ret = deflate(&zlib, Z_FINISH);
+        bytes.resize(zlib.total_out);
+        deflateEnd(&zlib);
+        if (ret != Z_STREAM_END)
+        {
+            throw std::runtime_error("Cannot compress ini data with gzip.");
+        }
+        return bytes;
+#else
+        throw std::runtime_error("Cannot write gzip-compressed ini data: built without zlib.");
+#endif
+    }
+    if (format == Format::Zstd)
+    {
+#ifdef INI_HAVE_ZSTD
+        std::string bytes(ZSTD_compressBound(text.size()), '\0');
+        const size_t size = ZSTD_compress(&bytes[0], bytes.size(), text.data(), text.size(), ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(size))
+        {
+            throw std::runtime_error(std::string("Cannot compress ini data with zstd: ") + ZSTD_getErrorName(size) + ".");
+        }
+        bytes.resize(size);
+        return bytes;
+#else
+        throw std::runtime_error("Cannot write zstd-compressed ini data: built without zstd.");
+#endif
+    }
+    return std::string(text);
+}
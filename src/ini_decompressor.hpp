@@ -0,0 +1,157 @@
+/**
+ * @file ini_decompressor.hpp
+ * @brief Streaming gzip and zstd decompression for INI sources.
+ * @details Detects compressed input by its magic bytes and inflates it block
+ *          by block, so callers can parse the text as it is produced. Plain
+ *          text is passed through unchanged.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_DECOMPRESSOR_HPP
+#define INI_DECOMPRESSOR_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @class IniDecompressor
+ * @brief Turns a possibly compressed byte stream into INI text.
+ * @details The format is chosen from the first bytes written: gzip (1f 8b),
+ *          zstd (28 b5 2f fd) or plain text. Decompressed output is handed to
+ *          a sink in blocks of at most output_size bytes as soon as it is
+ *          produced. Support for each codec is compiled in when the build
+ *          defines INI_HAVE_ZLIB or INI_HAVE_ZSTD; the Makefile does so when
+ *          pkg-config finds the library.
+ */
+class IniDecompressor
+{
+public:
+    /**
+     * @brief Encodings recognized by their magic bytes.
+     */
+    enum class Format
+    {
+        Unknown, ///< Too few bytes seen to decide.
+        Plain,   ///< Not compressed.
+        Gzip,    ///< gzip (RFC 1952), possibly several members.
+        Zstd     ///< Zstandard, possibly several frames.
+    };
+
+    /**
+     * @brief Receives decompressed text; returns false to stop.
+     */
+    using Sink = std::function<bool(std::string_view)>;
+
+    /**
+     * @brief Largest block handed to a sink in one call.
+     */
+    static constexpr size_t output_size = 65536;
+
+    IniDecompressor();
+    ~IniDecompressor();
+    IniDecompressor(const IniDecompressor &) = delete;
+    IniDecompressor &operator=(const IniDecompressor &) = delete;
+
+    /**
+     * @brief Decompresses the next bytes of input.
+     * @param input The next bytes of the stream.
+     * @param sink Receives the text produced.
+     * @return False if the sink asked to stop.
+     * @throws std::runtime_error if the data is corrupt or its codec is not built in.
+     */
+    bool write(std::string_view input, const Sink &sink);
+
+    /**
+     * @brief Ends the stream and flushes any bytes held for detection.
+     * @param sink Receives the text produced.
+     * @return False if the sink asked to stop.
+     * @throws std::runtime_error if a compressed stream was cut short.
+     */
+    bool finish(const Sink &sink);
+
+    /**
+     * @brief Returns the format detected so far.
+     */
+    Format format() const;
+
+    /**
+     * @brief Identifies the format from the start of a stream.
+     * @param head The first bytes of the stream.
+     * @return Unknown only if head is a short prefix of a magic number.
+     */
+    static Format detect(std::string_view head);
+
+    /**
+     * @brief Decompresses a complete buffer.
+     * @param bytes Compressed or plain data.
+     * @return The text, or a copy of bytes if they are plain.
+     * @throws std::runtime_error if the data is corrupt or its codec is not built in.
+     */
+    static std::string inflate(std::string_view bytes);
+
+    /**
+     * @brief Compresses text into a format that inflate() reads back.
+     * @details Used by IniFile::save() to write a compressed file back in
+     *          the format it was loaded in.
+     * @param text The text to compress.
+     * @param format Gzip or Zstd; Plain returns a copy of text.
+     * @return The compressed bytes.
+     * @throws std::runtime_error if the codec is not built in or fails.
+     */
+    static std::string compress(std::string_view text, Format format);
+
+private:
+    struct Stream;
+
+    /**
+     * @brief Starts the codec for the detected format.
+     * @throws std::runtime_error if the codec is not built in.
+     */
+    void start();
+
+    /**
+     * @brief Runs the codec over input.
+     * @param input Compressed bytes.
+     * @param sink Receives the text produced.
+     * @return False if the sink asked to stop.
+     */
+    bool decode(std::string_view input, const Sink &sink);
+
+    /**
+     * @brief Guesses the decompressed size from the stream headers.
+     * @param bytes A complete compressed buffer.
+     * @return The expected size, or 0 if unknown.
+     */
+    static size_t content_size(std::string_view bytes);
+
+    Format _format = Format::Unknown; ///< Detected format.
+    std::string _head;                ///< Leading bytes held until detection.
+    std::unique_ptr<Stream> _stream;  ///< Codec state, once started.
+};
+
+#endif // INI_DECOMPRESSOR_HPP
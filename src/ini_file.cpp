@@ -29,18 +29,82 @@
  */
 
 #include "ini_file.hpp"
+#include "ini_hash.hpp"
 
 #include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
-/**
- * @brief Tracks whether there are pending changes to be saved.
- */
-bool _pendingChanges = false;
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief Runs task(0) .. task(count - 1) on separate threads.
+     * @details The calling thread runs task(0) itself. The first exception
+     *          thrown by any task is rethrown once all threads have joined.
+     * @param count Number of tasks.
+     * @param task Callable taking the task index.
+     */
+    template <typename Task>
+    void run_parallel(size_t count, Task &&task)
+    {
+        if (count <= 1)
+        {
+            task(0);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> threads;
+        threads.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i)
+        {
+            threads.emplace_back([&task, &errors, i]
+                                 {
+                try
+                {
+                    task(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                } });
+        }
+
+        try
+        {
+            task(0);
+        }
+        catch (...)
+        {
+            errors[0] = std::current_exception();
+        }
+
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        for (const std::exception_ptr &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
 
 /**
  * @brief Returns the singleton IniFile instance.
@@ -62,18 +126,20 @@ IniFile &IniFile::instance()
  */
 void IniFile::set_filename(const std::string &filename)
 {
+    const auto lock = write_lock();
     _filename = filename;
-    load();
+    load_file();
 }
 
 /**
  * @brief Loads and parses the INI file into memory.
  *
  * @details
- * This method opens the file specified by `_filename`, reads it line-by-line,
- * and parses it into a section-key-value structure stored in `_data`.
- * It also keeps the original lines in `_lines` and maps keys to line numbers
- * in `_index`, allowing for comment preservation and in-place modification.
+ * This method reads the file specified by `_filename` into memory once and
+ * parses it in place into the flat section/key/value table `_data`, which
+ * also records the line number of every key. The original lines are kept in
+ * `_lines` as offsets into that buffer, allowing for comment preservation
+ * and in-place modification.
  *
  * Empty lines and comments are preserved but ignored in parsing.
  * Inline comments after values (e.g., `key = value ; comment`) are trimmed.
@@ -83,362 +149,2549 @@ void IniFile::set_filename(const std::string &filename)
  * @return true if the INI file was successfully loaded and parsed.
  */
 bool IniFile::load()
+{
+    const auto lock = write_lock();
+    return load_file();
+}
+
+/**
+ * @brief Reads and parses the file named by _filename.
+ * @details The body of load(), for callers already holding the lock.
+ * @return True once parsed.
+ * @throws std::runtime_error if `_filename` is empty or the file cannot be opened.
+ */
+bool IniFile::load_file()
 {
     if (_filename.empty())
     {
         throw std::runtime_error("Null value filename passed for load.");
     }
 
-    std::ifstream file(_filename);
-    if (!file.is_open())
+    if (!_source.open(_filename, _mmap))
     {
         throw std::runtime_error("Cannot open ini file " + _filename + ".");
     }
 
-    // Clear any previously loaded data
-    _data.clear();
-    _lines.clear();
-    _index.clear();
+    return parse_source();
+}
 
-    std::string line;
-    std::string current_section;
-    size_t line_num = 0;
+/**
+ * @brief Loads INI text that is already in memory.
+ * @details The text is copied once into the source buffer so that save()
+ *          can still reproduce its comments and formatting. gzip or zstd
+ *          data is decompressed straight into that buffer instead.
+ * @param text The INI text.
+ * @return True if the text was successfully parsed.
+ */
+bool IniFile::load(std::string_view text)
+{
+    const auto lock = write_lock();
+    _source.assign(IniDecompressor::inflate(text), IniDecompressor::detect(text));
+    return parse_source();
+}
 
-    // Read each line of the file
-    while (std::getline(file, line))
+/**
+ * @brief Loads INI text from an open file descriptor.
+ * @param fd A readable file descriptor; it is not closed.
+ * @return True if the data was successfully loaded and parsed.
+ * @throws std::runtime_error if the descriptor cannot be read.
+ */
+bool IniFile::load(int fd)
+{
+    const auto lock = write_lock();
+    if (fd < 0 || !_source.read(fd, _mmap))
     {
-        std::string trimmed = trim(line);
-        _lines.push_back(line); // Preserve original formatting
+        throw std::runtime_error("Cannot read ini data from file descriptor " + std::to_string(fd) + ".");
+    }
 
-        // Skip empty lines and full-line comments
-        if (trimmed.empty() || is_comment(trimmed))
-        {
-            line_num++;
-            continue;
-        }
+    return parse_source();
+}
+
+/**
+ * @brief Loads INI text from an input stream.
+ * @param in The stream to read to its end.
+ * @return True if the data was successfully loaded and parsed.
+ * @throws std::runtime_error if the stream fails while reading.
+ */
+bool IniFile::load(std::istream &in)
+{
+    std::string text;
+    IniDecompressor decompressor;
+    const IniDecompressor::Sink append = [&text](std::string_view out)
+    {
+        text.append(out.data(), out.size());
+        return true;
+    };
+
+    char buffer[65536];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+    {
+        decompressor.write(std::string_view(buffer, static_cast<size_t>(in.gcount())), append);
+    }
+    if (in.bad())
+    {
+        throw std::runtime_error("Cannot read ini data from stream.");
+    }
+    decompressor.finish(append);
+
+    const auto lock = write_lock();
+    _source.assign(std::move(text), decompressor.format());
+    return parse_source();
+}
+
+/**
+ * @brief Parses the contents of the source buffer.
+ * @details Shared by every load() overload once the bytes are in _source.
+ *          Depending on the settings the buffer is parsed sequentially, in
+ *          parallel chunks, or only indexed by section for lazy parsing.
+ * @return True once parsed.
+ */
+bool IniFile::parse_source()
+{
+    std::string_view text = _source.view();
+    _unparsed = decltype(_unparsed)(NameLess{_case_insensitive});
+    _snapshot.close();
+    _view_copy.reset();
+    ++_generation;
 
-        // Handle section headers like [section]
-        if (trimmed.front() == '[' && trimmed.back() == ']')
+    // Lazy mode: only find the sections now
+    if (_lazy)
+    {
+        _data.clear();
+        _data.fold_case(_case_insensitive);
+        _data.attach(text);
+        scan_source(false, _blocks);
+        for (size_t i = 0; i < _blocks.size(); ++i)
         {
-            current_section = trimmed.substr(1, trimmed.size() - 2);
+            _unparsed[_blocks[i].name].push_back(i);
         }
-        else
+        _modified = false;
+        // Concurrent readers hold only the shared lock, so nothing may stay pending
+        if (_thread_safe)
         {
-            // Handle key-value pairs like key = value
-            size_t pos = trimmed.find('=');
-            if (pos != std::string::npos)
-            {
-                std::string key = trim(trimmed.substr(0, pos));
-                std::string value = trim(trimmed.substr(pos + 1));
+            parse_all();
+        }
+        publish();
+        return true;
+    }
 
-                // Remove inline comment if present
-                size_t comment_pos = value.find_first_of(";#");
-                if (comment_pos != std::string::npos)
-                {
-                    value = trim(value.substr(0, comment_pos));
-                }
+    unsigned threads = (_load_threads != 0) ? _load_threads : std::thread::hardware_concurrency();
+    size_t workers = std::min<size_t>(std::max(threads, 1u), std::max<size_t>(text.size() / min_chunk_size, 1));
+    std::vector<Chunk> chunks = split_chunks(text, workers);
 
-                if (!key.empty())
-                {
-                    _data[current_section][key] = value;
-                    _index[current_section][key] = line_num;
-                }
-            }
-        }
+    // Count lines first so every worker knows where its lines start
+    run_parallel(chunks.size(), [&](size_t i)
+                 { chunks[i].line_count = IniScanner::count_lines(text.substr(chunks[i].begin, chunks[i].end - chunks[i].begin)); });
 
-        line_num++;
+    size_t total_lines = 0;
+    for (Chunk &chunk : chunks)
+    {
+        chunk.first_line = total_lines;
+        total_lines += chunk.line_count;
     }
 
-    file.close();
+    // Clear any previously loaded data; the first chunk parses into its buffers
+    _data.clear();
+    _blocks.clear();
+    std::swap(_data, chunks.front().table);
+    std::swap(_blocks, chunks.front().blocks);
+    for (Chunk &chunk : chunks)
+    {
+        chunk.table.fold_case(_case_insensitive);
+    }
+    _lines.assign(total_lines, LineSpan{0, 0});
+
+    run_parallel(chunks.size(), [&](size_t i)
+                 { parse_chunk(text, chunks[i], &_lines[chunks[i].first_line]); });
+
+    merge_chunks(chunks);
+
+    // Record section blocks so reload() can tell what changed
+    _blocks.swap(chunks.front().blocks);
+    for (size_t i = 1; i < chunks.size(); ++i)
+    {
+        std::move(chunks[i].blocks.begin(), chunks[i].blocks.end(), std::back_inserter(_blocks));
+    }
+    finish_blocks(text, total_lines, _blocks);
+    _modified = false;
+    publish();
+
     return true;
 }
 
 /**
- * @brief Saves the current INI file to disk.
- * @details Writes the stored key-value pairs back to the file while preserving
- *          comments and formatting. If a key exists in the data structure but
- *          not in the original file, it is written as a new entry.
- * @return True if the file was successfully saved, false otherwise.
- * @throws std::runtime_error If the filename is empty or if the file cannot be opened for writing.
+ * @brief Re-reads the INI file, re-parsing only sections that changed.
+ * @details The new file is read and split into section blocks, each of
+ *          which is hashed. A section counts as unchanged when its blocks
+ *          have the same hashes, in the same order, as at the last load.
+ *          Changed sections are dropped and re-parsed from their new blocks;
+ *          unchanged sections keep their values and have their line numbers
+ *          shifted to where their blocks now sit. Lines before the first
+ *          header form the unnamed section, which is only reported when it
+ *          holds keys before or after the reload; edits to a leading comment
+ *          block are not.
+ * @return Names of the sections that were added, changed, or removed.
+ * @throws std::runtime_error if `_filename` is empty or the file cannot be opened.
  */
-bool IniFile::save()
+std::vector<std::string> IniFile::reload()
 {
+    const auto lock = write_lock();
+    std::vector<std::string> changed;
+
+    // A leading block of comments is not a section; report it only if it has keys
+    const bool had_unnamed = unnamed_keys();
+    auto reported = [this, had_unnamed](std::vector<std::string> &names)
+    {
+        auto unnamed = std::find(names.begin(), names.end(), std::string());
+        if (unnamed != names.end() && !had_unnamed && !unnamed_keys())
+        {
+            names.erase(unnamed);
+        }
+        return std::move(names);
+    };
+
+    // In-memory edits or no previous load: everything may differ
+    if (_modified || _blocks.empty())
+    {
+        std::vector<SectionBlock> old_blocks = std::move(_blocks);
+        load_file();
+        for (const auto *blocks : {&_blocks, &old_blocks})
+        {
+            for (const SectionBlock &block : *blocks)
+            {
+                if (std::find(changed.begin(), changed.end(), block.name) == changed.end())
+                {
+                    changed.push_back(block.name);
+                }
+            }
+        }
+        return reported(changed);
+    }
+
     if (_filename.empty())
     {
-        throw std::runtime_error("Null value filename passed for save.");
+        throw std::runtime_error("Null value filename passed for load.");
     }
 
-    std::ofstream file(_filename);
-    if (!file.is_open())
+    // Lazy mode was switched off since the load: the sections it left
+    // pending index the old blocks, so parse them while the old text is here
+    if (!_lazy)
     {
-        throw std::runtime_error("Cannot write to file " + _filename + ".");
+        parse_all();
+    }
+    if (!_source.open(_filename, _mmap))
+    {
+        throw std::runtime_error("Cannot open ini file " + _filename + ".");
     }
 
-    std::string current_section;
-    for (size_t i = 0; i < _lines.size(); ++i)
+    std::string_view text = _source.view();
+    std::vector<SectionBlock> &new_blocks = _spare_blocks;
+    scan_source(!_lazy, new_blocks);
+
+    // Order block positions by section name, keeping file order within a name
+    const NameLess less{_data.folds_case()};
+    auto by_name = [&less](const std::vector<SectionBlock> &blocks, std::vector<size_t> &order)
+    {
+        order.resize(blocks.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&blocks, &less](size_t a, size_t b)
+                         { return less(blocks[a].name, blocks[b].name); });
+    };
+    std::vector<size_t> old_order;
+    std::vector<size_t> new_order;
+    by_name(_blocks, old_order);
+    by_name(new_blocks, new_order);
+
+    // Walk both orders together, one section name at a time
+    std::vector<size_t> reparse;
+    decltype(_unparsed) unparsed(less);
+    size_t old_pos = 0;
+    size_t new_pos = 0;
+    while (old_pos < old_order.size() || new_pos < new_order.size())
     {
-        std::string trimmed = trim(_lines[i]);
+        const bool from_old = new_pos == new_order.size() ||
+                              (old_pos < old_order.size() &&
+                               less(_blocks[old_order[old_pos]].name, new_blocks[new_order[new_pos]].name));
+        const std::string &name = from_old ? _blocks[old_order[old_pos]].name : new_blocks[new_order[new_pos]].name;
 
-        if (trimmed.empty() || is_comment(trimmed))
+        size_t old_end = old_pos;
+        while (old_end < old_order.size() && IniHash::equal(_blocks[old_order[old_end]].name, name, less.fold))
         {
-            file << _lines[i] << "\n";
-            continue;
+            ++old_end;
+        }
+        size_t new_end = new_pos;
+        while (new_end < new_order.size() && IniHash::equal(new_blocks[new_order[new_end]].name, name, less.fold))
+        {
+            ++new_end;
         }
 
-        if (trimmed.front() == '[' && trimmed.back() == ']')
+        // Unchanged when the blocks have the same hashes in the same order
+        const size_t count = new_end - new_pos;
+        bool same = (old_end - old_pos == count);
+        for (size_t i = 0; same && i < count; ++i)
         {
-            file << _lines[i] << "\n";
-            current_section = trimmed.substr(1, trimmed.size() - 2);
-            continue;
+            same = _blocks[old_order[old_pos + i]].hash == new_blocks[new_order[new_pos + i]].hash;
         }
 
-        size_t pos = trimmed.find('=');
-        if (pos != std::string::npos)
+        if (same)
         {
-            std::string key = trim(trimmed.substr(0, pos));
-            if (!key.empty() && _data.count(current_section) && _data.at(current_section).count(key))
+            // Unchanged: move line numbers and source offsets to the new blocks
+            bool moved = false;
+            for (size_t i = 0; i < count; ++i)
             {
-                file << key << " = " << _data.at(current_section).at(key) << "\n";
+                const SectionBlock &before = _blocks[old_order[old_pos + i]];
+                const SectionBlock &after = new_blocks[new_order[new_pos + i]];
+                moved = moved || before.first_line != after.first_line || before.begin != after.begin;
             }
-            else
+            size_t key = moved ? _data.section_first(name) : IniTable::npos;
+            for (; key != IniTable::npos; key = _data.next_in_section(key))
             {
-                file << _lines[i] << "\n";
+                const size_t line_num = _data.line(key);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const SectionBlock &before = _blocks[old_order[old_pos + i]];
+                    if (line_num >= before.first_line && line_num < before.first_line + before.line_count)
+                    {
+                        const SectionBlock &after = new_blocks[new_order[new_pos + i]];
+                        _data.relocate(key, line_num - before.first_line + after.first_line,
+                                       static_cast<std::ptrdiff_t>(after.begin) - static_cast<std::ptrdiff_t>(before.begin));
+                        break;
+                    }
+                }
             }
         }
         else
         {
-            file << _lines[i] << "\n";
+            changed.push_back(name);
+            reparse.insert(reparse.end(), new_order.begin() + new_pos, new_order.begin() + new_end);
+        }
+
+        // Lazy mode leaves changed sections for first use; unparsed ones stay so
+        if (_lazy && count > 0 && (!same || _unparsed.find(name) != _unparsed.end()))
+        {
+            unparsed.emplace(name, std::vector<size_t>(new_order.begin() + new_pos, new_order.begin() + new_end));
         }
+
+        old_pos = old_end;
+        new_pos = new_end;
     }
 
-    file.close();
-    return true;
-}
+    // Kept entries now point into the new source; drop changed and removed sections
+    _data.attach(text);
+    _data.erase_sections(changed, _spare_data);
+    _view_copy.reset();
+    ++_generation;
 
-/**
- * @brief Retrieves a value as a string from the INI file.
- * @param section The section name.
- * @param key The key name.
- * @return The corresponding value as a string.
- * @throws std::runtime_error If the section or key is not found.
- */
-std::string IniFile::get_value(const std::string &section, const std::string &key) const
-{
-    auto sec = _data.find(section);
-    if (sec == _data.end())
+    if (_lazy)
     {
-        throw std::runtime_error("Error retrieving [" + section + "] from '" + _filename + "'.");
+        _unparsed = std::move(unparsed);
+        _blocks.swap(new_blocks);
+        if (_thread_safe)
+        {
+            parse_all();
+        }
+        publish();
+        return reported(changed);
     }
 
-    auto val = sec->second.find(key);
-    if (val == sec->second.end())
+    // Parse the new blocks of changed sections, in file order
+    std::sort(reparse.begin(), reparse.end());
+    std::vector<Chunk> chunks(reparse.size());
+    for (size_t i = 0; i < reparse.size(); ++i)
     {
-        throw std::runtime_error("Error retrieving '" + key + "' from section [" + section + "].");
+        const SectionBlock &block = new_blocks[reparse[i]];
+        chunks[i].begin = block.begin;
+        chunks[i].end = block.end;
+        chunks[i].first_line = block.first_line;
+        chunks[i].line_count = block.line_count;
+        chunks[i].table.fold_case(_data.folds_case());
+        parse_chunk(text, chunks[i], nullptr);
     }
-    return val->second;
-}
+    merge_chunks(chunks);
 
-/**
- * @brief Retrieves a string value from the INI file.
- * @param section The section name.
- * @param key The key name.
- * @return The string representation of the stored value.
- * @throws std::runtime_error If the section or key is not found.
- */
-std::string IniFile::get_string_value(const std::string &section, const std::string &key) const
-{
-    return get_value(section, key);
+    _blocks.swap(new_blocks);
+    publish();
+    return reported(changed);
 }
 
 /**
- * @brief Retrieves an integer value from the INI file.
- * @param section The section name.
- * @param key The key name.
- * @return The integer representation of the stored value.
- * @throws std::runtime_error If the section or key is not found, or if the value cannot be converted to an integer.
+ * @brief Enables or disables lazy per-section parsing.
+ * @param lazy True to parse sections on first use; applies from the next load.
  */
-int IniFile::get_int_value(const std::string &section, const std::string &key) const
+void IniFile::set_lazy_load(bool lazy)
 {
-    std::string value = get_value(section, key); // Let this throw if needed
-    try
-    {
-        return std::stoi(value);
-    }
-    catch (const std::invalid_argument &)
-    {
-        throw std::runtime_error("Key '" + key + "' in section [" + section + "] is not a valid integer: '" + value + "'");
-    }
-    catch (const std::out_of_range &)
-    {
-        throw std::runtime_error("Key '" + key + "' in section [" + section + "] is out of range for integer: '" + value + "'");
-    }
+    const auto lock = write_lock();
+    _lazy = lazy;
 }
 
 /**
- * @brief Converts a string representation of a boolean value to a boolean.
- * @details Performs a case-insensitive comparison to determine if the string
- *          represents a true value. Accepts "true", "1", and variations of
- *          "True".
- * @param value The string to convert.
- * @return True if the string represents a true value, otherwise false.
+ * @brief Enables or disables memory-mapped loading.
+ * @param mapped True to map plain-text files rather than read them.
  */
-bool IniFile::string_to_bool(const std::string &value)
+void IniFile::set_mmap_load(bool mapped)
 {
-    std::string lower_value = value;
-    std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
-    return (lower_value == "true" || lower_value == "t" || lower_value == "1");
+    const auto lock = write_lock();
+    _mmap = mapped;
 }
 
 /**
- * @brief Retrieves a double value from the INI file.
- * @param section The section name.
- * @param key The key name.
- * @return The double representation of the stored value.
- * @throws std::runtime_error If the section or key is not found, or if the value
- *         cannot be converted to a double.
+ * @brief Enables or disables locking for use from several threads.
+ * @details Pending lazy sections are parsed now, so that reads never have
+ *          to change _data under the shared lock.
+ * @param enabled True to lock every call.
  */
-double IniFile::get_double_value(const std::string &section, const std::string &key) const
+void IniFile::set_thread_safe(bool enabled)
 {
-    std::string value = get_value(section, key); // Let this throw if needed
-    try
-    {
-        return std::stod(value);
-    }
-    catch (const std::invalid_argument &)
+    const std::unique_lock<std::shared_mutex> lock(_mutex);
+    while (enabled && !_unparsed.empty())
     {
-        throw std::runtime_error("Key '" + key + "' in section [" + section + "] is not a valid double: '" + value + "'");
-    }
-    catch (const std::out_of_range &)
-    {
-        throw std::runtime_error("Key '" + key + "' in section [" + section + "] is out of range for double: '" + value + "'");
+        parse_pending(_unparsed.begin()->first);
     }
+    _thread_safe = enabled;
+    _view_copy.reset();
 }
 
 /**
- * @brief Retrieves a boolean value from the INI file.
- * @param section The section name.
- * @param key The key name.
- * @return The boolean representation of the stored value.
- * @throws std::runtime_error If the section or key is not found.
+ * @brief Takes the exclusive lock in thread-safe mode.
  */
-bool IniFile::get_bool_value(const std::string &section, const std::string &key) const
+std::unique_lock<std::shared_mutex> IniFile::write_lock() const
 {
-    return string_to_bool(get_value(section, key));
+    return _thread_safe ? std::unique_lock<std::shared_mutex>(_mutex) : std::unique_lock<std::shared_mutex>();
 }
 
 /**
- * @brief Sets a string value in the INI file.
- * @param section The section name.
- * @param key The key name.
- * @param value The string value to set.
+ * @brief Takes the shared lock in thread-safe mode.
+ * @details Reads never parse in this mode, so the shared lock is enough
+ *          for them; see set_thread_safe().
  */
-// cppcheck-suppress unusedFunction
-void IniFile::set_string_value(const std::string &section, const std::string &key, const std::string &value)
+std::shared_lock<std::shared_mutex> IniFile::read_lock() const
 {
-    _data[section][key] = value;
-    _pendingChanges = true;
+    return _thread_safe ? std::shared_lock<std::shared_mutex>(_mutex) : std::shared_lock<std::shared_mutex>();
 }
 
 /**
- * @brief Converts a boolean value to a string representation.
- * @param value The boolean value to convert.
- * @return "true" if the value is true, otherwise "false".
+ * @brief Enables or disables case-insensitive section and key names.
+ * @param fold True to ignore ASCII case; applies from the next load.
  */
-std::string IniFile::bool_to_string(bool value)
+void IniFile::set_case_insensitive(bool fold)
 {
-    return value ? "true" : "false";
+    const auto lock = write_lock();
+    _case_insensitive = fold;
 }
 
 /**
- * @brief Sets a boolean value in the INI file.
- * @param section The section name.
- * @param key The key name.
- * @param value The boolean value to set.
+ * @brief Returns true if a sorts before b.
+ * @details Uses IniHash::less(), so names that IniHash::equal() matches are
+ *          equivalent.
  */
-void IniFile::set_bool_value(const std::string &section, const std::string &key, bool value)
+bool IniFile::NameLess::operator()(std::string_view a, std::string_view b) const
 {
-    _data[section][key] = bool_to_string(value);
-    _pendingChanges = true;
+    return IniHash::less(a, b, fold);
 }
 
 /**
- * @brief Sets an integer value in the INI file.
- * @param section The section name.
- * @param key The key name.
- * @param value The integer value to set.
+ * @brief Parses a section that lazy mode has not parsed yet.
+ * @details All blocks of the section are parsed together and merged so that
+ *          later duplicates win, exactly as a full load would.
+ * @param section The section name; nothing happens if it is parsed.
  */
-void IniFile::set_int_value(const std::string &section, const std::string &key, int value)
+void IniFile::parse_pending(std::string_view section) const
 {
-    _data[section][key] = std::to_string(value);
-    _pendingChanges = true;
+    auto pending = _unparsed.find(section);
+    if (pending == _unparsed.end())
+    {
+        return;
+    }
+
+    std::string_view text = _source.view();
+    std::vector<Chunk> chunks(pending->second.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        const SectionBlock &block = _blocks[pending->second[i]];
+        chunks[i].begin = block.begin;
+        chunks[i].end = block.end;
+        chunks[i].first_line = block.first_line;
+        chunks[i].table.fold_case(_data.folds_case());
+        parse_chunk(text, chunks[i], nullptr);
+    }
+
+    _unparsed.erase(pending);
+    merge_chunks(chunks);
 }
 
 /**
- * @brief Sets a double value in the INI file.
- * @param section The section name.
- * @param key The key name.
- * @param value The double value to set.
+ * @brief Returns true if lines before the first header hold keys.
+ * @details In lazy mode the unnamed section is parsed to find out; it is
+ *          at most the file's leading comment block.
  */
-void IniFile::set_double_value(const std::string &section, const std::string &key, double value)
+bool IniFile::unnamed_keys() const
 {
-    _data[section][key] = std::to_string(value);
-    _pendingChanges = true;
+    if (_snapshot.is_open())
+    {
+        return _snapshot.has_section(std::string_view());
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(std::string_view());
+    }
+    return _data.has_section(std::string_view());
 }
 
 /**
- * @brief Trims leading and trailing whitespace characters from a string.
- * @param str The input string to be trimmed.
- * @return A new string with whitespace removed from both ends.
+ * @brief Parses every pending section.
+ * @details Used before anything that needs the whole file, such as
+ *          getData() and save(). A mapped snapshot is unpacked first.
  */
-std::string IniFile::trim(const std::string &str)
+void IniFile::parse_all() const
 {
-    size_t first = str.find_first_not_of(" \t\r\n");
-    size_t last = str.find_last_not_of(" \t\r\n");
-    return (first == std::string::npos) ? "" : str.substr(first, (last - first + 1));
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+    while (!_unparsed.empty())
+    {
+        parse_pending(_unparsed.begin()->first);
+    }
 }
 
 /**
- * @brief Determines whether a given line is a comment.
- * @param line The line to check.
- * @return True if the line is a comment, false otherwise.
+ * @brief Sets how many threads load() may use.
+ * @param threads Worker count; 1 parses sequentially and 0 uses one thread
+ *                per hardware core.
  */
-bool IniFile::is_comment(const std::string &line)
+void IniFile::set_load_threads(unsigned threads)
 {
-    return line.empty() || line.front() == ';' || line.front() == '#';
+    const auto lock = write_lock();
+    _load_threads = threads;
 }
 
 /**
- * @brief Commits any pending changes by saving the INI file.
- * @details If there are unsaved changes, this function writes them to the file
- *          and resets the pending changes flag.
+ * @brief Merges parsed chunks into _data.
+ * @details Chunks are applied in file order, so the later entry wins for
+ *          duplicate keys. When _data is empty the first chunk's table is
+ *          moved in whole instead of being copied.
+ * @param chunks Parsed chunks in file order; emptied by the merge.
  */
-// cppcheck-suppress unusedFunction
-void IniFile::commit_changes()
+void IniFile::merge_chunks(std::vector<Chunk> &chunks) const
 {
-    if (_pendingChanges)
+    for (Chunk &chunk : chunks)
     {
-        save();
-        _pendingChanges = false;
+        if (_data.size() == 0 && _data.section_count() == 0)
+        {
+            _data = std::move(chunk.table);
+        }
+        else
+        {
+            _data.merge(chunk.table);
+        }
+        chunk.table.clear();
     }
 }
 
 /**
- * @brief Retrieves the parsed INI data.
- * @return A const reference to the internal data storage.
+ * @brief Completes blocks that only have their start recorded.
+ * @param text The INI text.
+ * @param total_lines Number of lines in text.
+ * @param blocks Blocks with name, begin and first_line set, in order.
  */
-const std::map<std::string, std::unordered_map<std::string, std::string>> &IniFile::getData() const
+void IniFile::finish_blocks(std::string_view text, size_t total_lines, std::vector<SectionBlock> &blocks)
 {
-    return _data;
+    // Lines before the first header belong to the unnamed section
+    size_t first_header = blocks.empty() ? total_lines : blocks.front().first_line;
+    if (first_header > 0)
+    {
+        blocks.insert(blocks.begin(), SectionBlock{std::string(), 0, 0, 0, 0, 0});
+    }
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        bool last = (i + 1 == blocks.size());
+        blocks[i].end = last ? text.size() : blocks[i + 1].begin;
+        blocks[i].line_count = (last ? total_lines : blocks[i + 1].first_line) - blocks[i].first_line;
+        blocks[i].hash = hash_bytes(text.substr(blocks[i].begin, blocks[i].end - blocks[i].begin));
+    }
 }
 
 /**
- * @brief Sets the internal data of the INI file.
- *
- * @param data A new mapping of sections to key/value pairs.
- * @return True if the data was set successfully.
+ * @brief Hashes a byte range for change detection.
+ * @details Mixes eight bytes per step with a multiply and fold, which is fast
+ *          enough to run over the whole file on every reload.
+ * @param bytes The bytes to hash.
+ * @return A 64-bit hash; not suitable for untrusted input.
  */
-// cppcheck-suppress unusedFunction
-void IniFile::setData(const std::map<std::string, std::unordered_map<std::string, std::string>> &data)
+uint64_t IniFile::hash_bytes(std::string_view bytes)
 {
-    _data = data;
+    const uint64_t multiplier = 0xff51afd7ed558ccdULL;
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ bytes.size();
+
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 32;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+    hash = (hash ^ tail) * multiplier;
+    hash ^= hash >> 29;
+    hash *= multiplier;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Splits text into at most count chunks at section headers.
+ * @details Each split point is the first section header at or after an even
+ *          division of the text. Fewer chunks are returned when headers are
+ *          too sparse.
+ * @param text The text to split.
+ * @param count The desired number of chunks.
+ * @return Chunks covering text in order; at least one.
+ */
+std::vector<IniFile::Chunk> IniFile::split_chunks(std::string_view text, size_t count)
+{
+    std::vector<Chunk> chunks(1);
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        size_t target = text.size() / count * i;
+        if (target <= chunks.back().begin)
+        {
+            continue;
+        }
+
+        // Start from the next whole line
+        size_t start = target;
+        if (text[target - 1] != '\n')
+        {
+            start = text.find('\n', target);
+            if (start == std::string_view::npos)
+            {
+                break;
+            }
+            ++start;
+        }
+
+        // Advance to the next section header
+        std::string_view rest = text.substr(start);
+        IniScanner scanner(rest);
+        IniScanner::Line span;
+        size_t header = std::string_view::npos;
+        while (scanner.next(span))
+        {
+            if (tokenize(rest, span).kind == LineKind::Section)
+            {
+                header = start + span.begin;
+                break;
+            }
+        }
+        if (header == std::string_view::npos)
+        {
+            break;
+        }
+
+        if (header > chunks.back().begin)
+        {
+            chunks.back().end = header;
+            chunks.emplace_back();
+            chunks.back().begin = header;
+        }
+    }
+
+    chunks.back().end = text.size();
+    return chunks;
+}
+
+/**
+ * @brief Parses one chunk into its own maps and, optionally, its lines.
+ * @details Workers write disjoint ranges of the pre-sized _lines and keep
+ *          their own maps, so chunks can be parsed concurrently.
+ * @param text The full source text.
+ * @param chunk The chunk to parse; first_line must already be set.
+ * @param lines Where to record the chunk's lines, or nullptr.
+ */
+void IniFile::parse_chunk(std::string_view text, Chunk &chunk, LineSpan *lines)
+{
+    std::string_view slice = text.substr(chunk.begin, chunk.end - chunk.begin);
+    chunk.table.attach(text);
+
+    std::string current_section;
+
+    // Parse each line of the chunk
+    size_t line_num = chunk.first_line;
+    IniScanner scanner(slice);
+    IniScanner::Line span;
+    while (scanner.next(span))
+    {
+        if (lines != nullptr)
+        {
+            lines[line_num - chunk.first_line] = {chunk.begin + span.begin, span.end - span.begin};
+        }
+        LineToken token = tokenize(slice, span);
+
+        if (token.kind == LineKind::Section)
+        {
+            current_section.assign(token.name);
+            chunk.blocks.push_back(SectionBlock{current_section, chunk.begin + span.begin, 0, line_num, 0, 0});
+        }
+        else if (token.kind == LineKind::KeyValue)
+        {
+            // Sections only appear in _data once they hold a key; the entry
+            // points at the key and value bytes instead of copying them
+            chunk.table.refer(current_section, token.key, token.value, line_num);
+        }
+
+        line_num++;
+    }
+}
+
+/**
+ * @brief Streams an INI file through a visitor without storing it.
+ * @details The file is read in 64 KiB blocks and gzip or zstd data is
+ *          decompressed as it arrives. Complete lines are parsed as soon as
+ *          they are available and any partial line is carried into the next
+ *          block; the carry only grows if a single line is longer than that.
+ * @param filename Path to the INI file.
+ * @param visitor Receives the parse events.
+ * @return True if the whole file was parsed, false if the visitor stopped early.
+ * @throws std::runtime_error if the file cannot be opened or read.
+ */
+bool IniFile::parse(const std::string &filename, IniVisitor &visitor)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open ini file " + filename + ".");
+    }
+
+    VisitState state{visitor, std::string(), 0};
+    std::string pending;
+    pending.reserve(2 * IniDecompressor::output_size);
+
+    // Parse up to the last newline and keep the partial line for later
+    const IniDecompressor::Sink consume = [&pending, &state](std::string_view text)
+    {
+        pending.append(text.data(), text.size());
+        size_t complete = pending.rfind('\n');
+        if (complete == std::string::npos)
+        {
+            return true;
+        }
+        ++complete;
+        if (!visit_lines(std::string_view(pending).substr(0, complete), state))
+        {
+            return false;
+        }
+        pending.erase(0, complete);
+        return true;
+    };
+
+    IniDecompressor decompressor;
+    char buffer[65536];
+    bool finished = false;
+    try
+    {
+        for (;;)
+        {
+            ssize_t n = ::read(fd, buffer, sizeof(buffer));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::runtime_error("Cannot read ini file " + filename + ".");
+            }
+            if (n == 0)
+            {
+                finished = decompressor.finish(consume) && visit_lines(pending, state);
+                break;
+            }
+            if (!decompressor.write(std::string_view(buffer, static_cast<size_t>(n)), consume))
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+
+    ::close(fd);
+    return finished;
+}
+
+/**
+ * @brief Streams INI text already in memory through a visitor.
+ * @param text The INI text.
+ * @param visitor Receives the parse events.
+ * @return True if all text was parsed, false if the visitor stopped early.
+ */
+bool IniFile::parse_buffer(std::string_view text, IniVisitor &visitor)
+{
+    VisitState state{visitor, std::string(), 0};
+    return visit_lines(text, state);
+}
+
+/**
+ * @brief Parses complete lines of text and reports them to a visitor.
+ * @param text Whole lines; the last may lack its newline.
+ * @param state Visitor and state carried from earlier text.
+ * @return False if the visitor asked to stop.
+ */
+bool IniFile::visit_lines(std::string_view text, VisitState &state)
+{
+    IniScanner scanner(text);
+    IniScanner::Line span;
+    while (scanner.next(span))
+    {
+        size_t line_num = state.line_num++;
+        LineToken token = tokenize(text, span);
+
+        bool keep_going = true;
+        switch (token.kind)
+        {
+        case LineKind::Section:
+            state.section.assign(token.name);
+            keep_going = state.visitor.on_section(token.name, line_num);
+            break;
+        case LineKind::KeyValue:
+            keep_going = state.visitor.on_key_value(state.section, token.key, token.value, line_num);
+            break;
+        case LineKind::Comment:
+            keep_going = state.visitor.on_comment(token.name, line_num);
+            break;
+        default:
+            break;
+        }
+
+        if (!keep_going)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Saves the current INI file to disk.
+ * @details Writes the stored key-value pairs back to the file while preserving
+ *          comments and formatting. If a key exists in the data structure but
+ *          not in the original file, it is written as a new entry.
+ *
+ *          The output is assembled in memory from the original lines, then
+ *          becomes the new source buffer. Data loaded from gzip or zstd is
+ *          compressed again so the file keeps its format.
+ * @return True if the file was successfully saved, false otherwise.
+ * @throws std::runtime_error If the filename is empty, the file cannot be opened for writing, or
+ *         its compression codec is not built in.
+ */
+bool IniFile::save()
+{
+    const auto lock = write_lock();
+    return save_file();
+}
+
+/**
+ * @brief Writes the file named by _filename.
+ * @details The body of save(), for callers already holding the lock.
+ * @return True if the file was successfully saved.
+ * @throws std::runtime_error If the filename is empty, the file cannot be opened for writing, or
+ *         its compression codec is not built in.
+ */
+bool IniFile::save_file()
+{
+    if (_filename.empty())
+    {
+        throw std::runtime_error("Null value filename passed for save.");
+    }
+
+    parse_all();
+
+    // Lazy loads skip the line table
+    if (_lines.empty() && !_source.view().empty())
+    {
+        scan_source(true, _blocks);
+    }
+
+    std::string out;
+    out.reserve(_source.view().size() + _lines.size());
+
+    // Keys before the first header belong to the unnamed section
+    std::string current_section;
+    struct Written
+    {
+        size_t entry; ///< Entry index in _data.
+        size_t key;   ///< Offset of the key in out.
+        size_t value; ///< Offset of the value in out.
+    };
+    std::vector<Written> written;
+    written.reserve(_data.size());
+    for (size_t i = 0; i < _lines.size(); ++i)
+    {
+        std::string_view original = line(i);
+        LineToken token = tokenize(original);
+
+        if (token.kind == LineKind::Section)
+        {
+            current_section.assign(token.name);
+        }
+        else if (token.kind == LineKind::KeyValue)
+        {
+            size_t entry = _data.find(current_section, token.key);
+            if (entry != IniTable::npos)
+            {
+                const size_t key_offset = out.size();
+                out.append(token.key).append(" = ");
+                written.push_back(Written{entry, key_offset, out.size()});
+                out.append(_data.value(entry)).append("\n");
+                continue;
+            }
+        }
+
+        out.append(original).append("\n");
+    }
+
+    // Nothing changes in memory unless the whole file was written, so a
+    // failed save keeps the edits and reload() still re-reads everything
+    const IniDecompressor::Format format = _source.format();
+    std::string packed;
+    if (format != IniDecompressor::Format::Plain)
+    {
+        packed = IniDecompressor::compress(out, format);
+    }
+    const std::string_view bytes = packed.empty() ? std::string_view(out) : std::string_view(packed);
+
+    // Truncating a mapped file would pull the old text out from under the
+    // entries if the write fails, so keep a copy of it first
+    if (_source.mapped_size() != 0)
+    {
+        _source.assign(std::string(_source.view()), format);
+        _data.attach(_source.view());
+    }
+
+    std::ofstream file(_filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Cannot write to file " + _filename + ".");
+    }
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (!file)
+    {
+        throw std::runtime_error("Cannot write to file " + _filename + ".");
+    }
+
+    // The written text replaces the source; point every written entry at
+    // its new line instead of the old bytes
+    _source.assign(std::move(out), format);
+    _data.attach(_source.view());
+    for (const Written &place : written)
+    {
+        _data.rebind(place.entry, place.key, place.value);
+    }
+    scan_source(true, _blocks);
+    _modified = false;
+    return true;
+}
+
+/**
+ * @brief Writes the parsed data to a binary snapshot (.inib) file.
+ * @details The snapshot stores the current source text's size and hash so
+ *          load_snapshot() can tell when the INI file has changed since.
+ *          Unsaved changes are refused because they are not in that text.
+ * @param path Path of the snapshot file.
+ * @return True if the snapshot was written.
+ * @throws std::runtime_error if there are unsaved changes or the file cannot be written.
+ */
+bool IniFile::save_snapshot(const std::string &path)
+{
+    const auto lock = write_lock();
+    parse_all();
+    if (_modified)
+    {
+        throw std::runtime_error("Cannot snapshot unsaved changes to " + _filename + "; call save() first.");
+    }
+
+    std::vector<IniSnapshot::Record> records;
+    records.reserve(_data.size());
+    for (size_t i = 0; i < _data.size(); ++i)
+    {
+        size_t line_num = (_data.line(i) != IniTable::npos) ? _data.line(i) : 0;
+        records.push_back(IniSnapshot::Record{_data.section(i), _data.key(i), _data.value(i), line_num});
+    }
+
+    std::string_view text = _source.view();
+    std::string bytes = IniSnapshot::build(std::move(records), hash_bytes(text), text.size());
+
+    // Write beside the target and rename, so mapped readers keep the old file
+    const std::string temp = path + ".tmp";
+    std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Cannot write to file " + temp + ".");
+    }
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (!file || std::rename(temp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temp.c_str());
+        throw std::runtime_error("Cannot write to file " + path + ".");
+    }
+    return true;
+}
+
+/**
+ * @brief Sets the filename and loads it from a snapshot if possible.
+ * @details The INI file is read and hashed, which is far cheaper than
+ *          parsing it. Only if its size and hash match the snapshot header
+ *          does the snapshot replace the current data; otherwise the file is
+ *          parsed normally.
+ * @param filename Path to the INI file.
+ * @param path Path of the snapshot file.
+ * @return True if the snapshot was used, false if the file was parsed.
+ * @throws std::runtime_error if the INI file cannot be opened.
+ */
+bool IniFile::load_snapshot(const std::string &filename, const std::string &path)
+{
+    const auto lock = write_lock();
+    _filename = filename;
+
+    IniSnapshot snapshot;
+    Source source;
+    if (!snapshot.open(path) || !source.open(_filename, _mmap))
+    {
+        load_file();
+        return false;
+    }
+
+    std::string_view text = source.view();
+    if (text.size() != snapshot.source_size() || hash_bytes(text) != snapshot.source_hash())
+    {
+        load_file();
+        return false;
+    }
+
+    _source.swap(source);
+    _snapshot.swap(snapshot);
+    _data.clear();
+    _data.fold_case(_case_insensitive);
+    _view_copy.reset();
+    ++_generation;
+    _lines.clear();
+    _blocks.clear();
+    _unparsed.clear();
+    _modified = false;
+
+    // Snapshot lookups match names exactly, so fold them into _data now
+    if (_case_insensitive)
+    {
+        unpack_snapshot();
+    }
+    publish();
+    return true;
+}
+
+/**
+ * @brief Copies the mapped snapshot into _data and closes it.
+ * @details The line table is rebuilt by save() when it is needed.
+ */
+void IniFile::unpack_snapshot() const
+{
+    _data.clear();
+    ++_generation;
+    _snapshot.unpack([this](std::string_view section, std::string_view key, std::string_view value, size_t line_num)
+                     { _data.set(section, key, value, line_num); });
+    _snapshot.close();
+}
+
+/**
+ * @brief Retrieves a value as a string from the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The corresponding value as a string.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+std::string IniFile::get_value(std::string_view section, std::string_view key) const
+{
+    const auto lock = read_lock();
+    return read_value(section, key);
+}
+
+/**
+ * @brief Retrieves a value as a string, without locking.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The corresponding value as a string.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+std::string IniFile::read_value(std::string_view section, std::string_view key) const
+{
+    if (_snapshot.is_open())
+    {
+        std::string_view value;
+        if (_snapshot.find(section, key, value))
+        {
+            return std::string(value);
+        }
+        if (!_snapshot.has_section(section))
+        {
+            throw std::runtime_error("Error retrieving [" + std::string(section) + "] from '" + _filename + "'.");
+        }
+        throw std::runtime_error("Error retrieving '" + std::string(key) + "' from section [" + std::string(section) + "].");
+    }
+
+    size_t entry = lookup(section, key);
+    if (entry == IniTable::npos)
+    {
+        if (!_data.has_section(section))
+        {
+            throw std::runtime_error("Error retrieving [" + std::string(section) + "] from '" + _filename + "'.");
+        }
+        throw std::runtime_error("Error retrieving '" + std::string(key) + "' from section [" + std::string(section) + "].");
+    }
+    return std::string(_data.value(entry));
+}
+
+/**
+ * @brief Retrieves a string value from the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The string representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+std::string IniFile::get_string_value(std::string_view section, std::string_view key) const
+{
+    const auto lock = read_lock();
+    return read_value(section, key);
+}
+
+/**
+ * @brief Retrieves an integer value from the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The integer representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found, or if the value cannot be converted to an integer.
+ */
+int IniFile::get_int_value(std::string_view section, std::string_view key) const
+{
+    const auto lock = read_lock();
+    return cached_int(lookup(section, key), section, key); // Let this throw if needed
+}
+
+/**
+ * @brief Finds the entry for a section and key in _data.
+ * @details Parses the section first if lazy mode has not yet.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The entry index, or IniTable::npos if the key is missing or a
+ *         snapshot is serving lookups.
+ */
+size_t IniFile::lookup(std::string_view section, std::string_view key) const
+{
+    if (_snapshot.is_open())
+    {
+        return IniTable::npos;
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    return _data.find(section, key);
+}
+
+/**
+ * @brief Finds the entry for a section and key from a precomputed hash.
+ * @details Parses the section first if lazy mode has not yet.
+ * @param hash IniHash::key() of section and key, folded if _data folds case.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The entry index, or IniTable::npos if the key is missing or a
+ *         snapshot is serving lookups.
+ */
+size_t IniFile::lookup(uint64_t hash, std::string_view section, std::string_view key) const
+{
+    if (_snapshot.is_open())
+    {
+        return IniTable::npos;
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    return _data.find(hash, section, key);
+}
+
+/**
+ * @brief Returns an entry as an integer, parsing it only on first use.
+ * @details Without an entry the value is fetched and parsed by name, which
+ *          serves snapshots and reports missing keys.
+ * @param entry Entry index in _data, or IniTable::npos.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The integer value.
+ * @throws std::runtime_error If the key is not found or is not a valid integer.
+ */
+int IniFile::cached_int(size_t entry, std::string_view section, std::string_view key) const
+{
+    if (entry == IniTable::npos)
+    {
+        return to_int(read_value(section, key), section, key);
+    }
+
+    IniTable::Typed &typed = _data.typed(entry);
+    if (typed.kind == IniTable::Typed::int_value)
+    {
+        return static_cast<int>(typed.as_int);
+    }
+    const int value = to_int(std::string(_data.value(entry)), section, key);
+    // Concurrent readers share the entry, so only single-threaded reads fill the cache
+    if (!_thread_safe)
+    {
+        typed.as_int = value;
+        typed.kind = IniTable::Typed::int_value;
+    }
+    return value;
+}
+
+/**
+ * @brief Returns an entry as a double, parsing it only on first use.
+ * @param entry Entry index in _data, or IniTable::npos.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The double value.
+ * @throws std::runtime_error If the key is not found or is not a valid double.
+ */
+double IniFile::cached_double(size_t entry, std::string_view section, std::string_view key) const
+{
+    if (entry == IniTable::npos)
+    {
+        return to_double(read_value(section, key), section, key);
+    }
+
+    IniTable::Typed &typed = _data.typed(entry);
+    if (typed.kind == IniTable::Typed::double_value)
+    {
+        return typed.as_double;
+    }
+    const double value = to_double(std::string(_data.value(entry)), section, key);
+    // Concurrent readers share the entry, so only single-threaded reads fill the cache
+    if (!_thread_safe)
+    {
+        typed.as_double = value;
+        typed.kind = IniTable::Typed::double_value;
+    }
+    return value;
+}
+
+/**
+ * @brief Returns an entry as a boolean, parsing it only on first use.
+ * @param entry Entry index in _data, or IniTable::npos.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The boolean value.
+ * @throws std::runtime_error If the key is not found.
+ */
+bool IniFile::cached_bool(size_t entry, std::string_view section, std::string_view key) const
+{
+    if (entry == IniTable::npos)
+    {
+        return string_to_bool(read_value(section, key));
+    }
+
+    IniTable::Typed &typed = _data.typed(entry);
+    if (typed.kind == IniTable::Typed::bool_value)
+    {
+        return typed.as_bool;
+    }
+    const bool value = string_to_bool(_data.value(entry));
+    // Concurrent readers share the entry, so only single-threaded reads fill the cache
+    if (!_thread_safe)
+    {
+        typed.as_bool = value;
+        typed.kind = IniTable::Typed::bool_value;
+    }
+    return value;
+}
+
+/**
+ * @brief Converts a stored value to an integer.
+ * @param value The stored value.
+ * @param section The section name, for error messages.
+ * @param key The key name, for error messages.
+ * @return The integer value.
+ * @throws std::runtime_error if the value is not a valid integer.
+ */
+int IniFile::to_int(const std::string &value, std::string_view section, std::string_view key)
+{
+    try
+    {
+        return std::stoi(value);
+    }
+    catch (const std::invalid_argument &)
+    {
+        throw std::runtime_error("Key '" + std::string(key) + "' in section [" + std::string(section) + "] is not a valid integer: '" + value + "'");
+    }
+    catch (const std::out_of_range &)
+    {
+        throw std::runtime_error("Key '" + std::string(key) + "' in section [" + std::string(section) + "] is out of range for integer: '" + value + "'");
+    }
+}
+
+/**
+ * @brief Converts a string representation of a boolean value to a boolean.
+ * @details Performs a case-insensitive comparison in place, without a
+ *          lowered copy, to determine if the string represents a true value.
+ *          Accepts "true", "t", "1", and variations of "True".
+ * @param value The string to convert.
+ * @return True if the string represents a true value, otherwise false.
+ */
+bool IniFile::string_to_bool(std::string_view value)
+{
+    return IniHash::equal(value, "true", true) || IniHash::equal(value, "t", true) || value == "1";
+}
+
+/**
+ * @brief Retrieves a double value from the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The double representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found, or if the value
+ *         cannot be converted to a double.
+ */
+double IniFile::get_double_value(std::string_view section, std::string_view key) const
+{
+    const auto lock = read_lock();
+    return cached_double(lookup(section, key), section, key); // Let this throw if needed
+}
+
+/**
+ * @brief Converts a stored value to a double.
+ * @param value The stored value.
+ * @param section The section name, for error messages.
+ * @param key The key name, for error messages.
+ * @return The double value.
+ * @throws std::runtime_error if the value is not a valid double.
+ */
+double IniFile::to_double(const std::string &value, std::string_view section, std::string_view key)
+{
+    try
+    {
+        return std::stod(value);
+    }
+    catch (const std::invalid_argument &)
+    {
+        throw std::runtime_error("Key '" + std::string(key) + "' in section [" + std::string(section) + "] is not a valid double: '" + value + "'");
+    }
+    catch (const std::out_of_range &)
+    {
+        throw std::runtime_error("Key '" + std::string(key) + "' in section [" + std::string(section) + "] is out of range for double: '" + value + "'");
+    }
+}
+
+/**
+ * @brief Retrieves a boolean value from the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The boolean representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+bool IniFile::get_bool_value(std::string_view section, std::string_view key) const
+{
+    const auto lock = read_lock();
+    return cached_bool(lookup(section, key), section, key);
+}
+
+/**
+ * @brief Sets a string value in the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value The string value to set.
+ */
+// cppcheck-suppress unusedFunction
+void IniFile::set_string_value(std::string_view section, std::string_view key, std::string_view value)
+{
+    const auto lock = write_lock();
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    _data.set(section, key, value);
+    _modified = true;
+    _pending_changes = true;
+    _view_copy.reset();
+    publish();
+}
+
+/**
+ * @brief Converts a boolean value to a string representation.
+ * @param value The boolean value to convert.
+ * @return "true" if the value is true, otherwise "false".
+ */
+std::string IniFile::bool_to_string(bool value)
+{
+    return value ? "true" : "false";
+}
+
+/**
+ * @brief Sets a boolean value in the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value The boolean value to set.
+ */
+void IniFile::set_bool_value(std::string_view section, std::string_view key, bool value)
+{
+    const auto lock = write_lock();
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    IniTable::Typed &typed = _data.typed(_data.set(section, key, bool_to_string(value)));
+    typed.as_bool = value;
+    typed.kind = IniTable::Typed::bool_value;
+    _modified = true;
+    _pending_changes = true;
+    _view_copy.reset();
+    publish();
+}
+
+/**
+ * @brief Sets an integer value in the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value The integer value to set.
+ */
+void IniFile::set_int_value(std::string_view section, std::string_view key, int value)
+{
+    const auto lock = write_lock();
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    IniTable::Typed &typed = _data.typed(_data.set(section, key, std::to_string(value)));
+    typed.as_int = value;
+    typed.kind = IniTable::Typed::int_value;
+    _modified = true;
+    _pending_changes = true;
+    _view_copy.reset();
+    publish();
+}
+
+/**
+ * @brief Sets a double value in the INI file.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value The double value to set.
+ */
+void IniFile::set_double_value(std::string_view section, std::string_view key, double value)
+{
+    const auto lock = write_lock();
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    _data.set(section, key, std::to_string(value));
+    _modified = true;
+    _pending_changes = true;
+    _view_copy.reset();
+    publish();
+}
+
+/**
+ * @brief Returns the section name.
+ */
+const std::string &KeyHandle::section() const
+{
+    return _section;
+}
+
+/**
+ * @brief Returns the key name.
+ */
+const std::string &KeyHandle::key() const
+{
+    return _key;
+}
+
+/**
+ * @brief Resolves a section and key to a handle for repeated access.
+ * @details The key does not have to exist yet; a handle to a missing key
+ *          throws on get_* and creates the key on set_*.
+ * @param section The section name.
+ * @param key The key name.
+ * @return A handle usable with the get_* and set_* overloads.
+ */
+KeyHandle IniFile::resolve(std::string_view section, std::string_view key) const
+{
+    const auto lock = read_lock();
+    KeyHandle handle;
+    handle._section = section;
+    handle._key = key;
+    handle._hash = _data.hash(section, key);
+    locate(handle);
+    return handle;
+}
+
+/**
+ * @brief Finds the entry of a handle, refreshing its cached index.
+ * @details A cached index from the current generation is returned as is.
+ *          Otherwise the entry is probed from the stored hash, which costs
+ *          one slot lookup and one key compare.
+ * @param handle Handle from resolve().
+ * @return The entry index in _data, or IniTable::npos if the key is
+ *         missing or a snapshot is serving lookups.
+ */
+size_t IniFile::locate(const KeyHandle &handle) const
+{
+    if (handle._generation == _generation && handle._entry != IniTable::npos)
+    {
+        return handle._entry;
+    }
+    if (_snapshot.is_open())
+    {
+        return IniTable::npos;
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(handle._section);
+    }
+
+    // A load may have switched case folding, which changes the hash
+    handle._hash = _data.hash(handle._section, handle._key);
+    handle._entry = _data.find(handle._hash, handle._section, handle._key);
+    handle._generation = _generation;
+    return handle._entry;
+}
+
+/**
+ * @brief Retrieves a string value through a resolved handle.
+ * @details Missing keys and mapped snapshots fall back to the named lookup,
+ *          which serves the snapshot or reports the error.
+ * @param handle Handle from resolve().
+ * @return The corresponding value as a string.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+std::string IniFile::get_value(const KeyHandle &handle) const
+{
+    const auto lock = read_lock();
+    return read_value(handle);
+}
+
+/**
+ * @brief Retrieves a value through a resolved handle, without locking.
+ * @param handle Handle from resolve().
+ * @return The corresponding value as a string.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+std::string IniFile::read_value(const KeyHandle &handle) const
+{
+    size_t entry = locate(handle);
+    if (entry == IniTable::npos)
+    {
+        return read_value(handle._section, handle._key);
+    }
+    return std::string(_data.value(entry));
+}
+
+/**
+ * @brief Retrieves a string value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @return The string representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+std::string IniFile::get_string_value(const KeyHandle &handle) const
+{
+    const auto lock = read_lock();
+    return read_value(handle);
+}
+
+/**
+ * @brief Retrieves a boolean value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @return The boolean representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found.
+ */
+bool IniFile::get_bool_value(const KeyHandle &handle) const
+{
+    const auto lock = read_lock();
+    return cached_bool(locate(handle), handle._section, handle._key);
+}
+
+/**
+ * @brief Retrieves an integer value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @return The integer representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found, or if the value cannot be converted to an integer.
+ */
+int IniFile::get_int_value(const KeyHandle &handle) const
+{
+    const auto lock = read_lock();
+    return cached_int(locate(handle), handle._section, handle._key);
+}
+
+/**
+ * @brief Retrieves a double value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @return The double representation of the stored value.
+ * @throws std::runtime_error If the section or key is not found, or if the value
+ *         cannot be converted to a double.
+ */
+double IniFile::get_double_value(const KeyHandle &handle) const
+{
+    const auto lock = read_lock();
+    return cached_double(locate(handle), handle._section, handle._key);
+}
+
+/**
+ * @brief Reads a list of fields into their members.
+ * @details Walks the fields one section at a time, probing each key with
+ *          its precomputed hash and converting it through the typed cache.
+ *          Sections are only looked up when a key is missing, so that a
+ *          missing section is reported once for all of its fields. Errors
+ *          are collected rather than thrown so that one call reports
+ *          everything wrong with the file.
+ * @param fields The fields, grouped by section.
+ * @param count Number of fields.
+ * @throws std::runtime_error listing every field that could not be read.
+ */
+void IniFile::bind(const IniBoundField *fields, size_t count) const
+{
+    const auto lock = read_lock();
+    std::string errors;
+    const bool fold = _data.folds_case();
+    size_t first = 0;
+    while (first < count)
+    {
+        const std::string_view section = fields[first].section;
+        size_t last = first + 1;
+        while (last < count && fields[last].section == section)
+        {
+            ++last;
+        }
+
+        for (; first < last; ++first)
+        {
+            const IniBoundField &field = fields[first];
+            // Snapshots are served by name through the npos paths below
+            const size_t entry = lookup(fold ? field.folded_hash : field.hash, section, field.key);
+            if (entry == IniTable::npos &&
+                !(_snapshot.is_open() ? _snapshot.has_section(section) : _data.has_section(section)))
+            {
+                errors += "Error retrieving [" + std::string(section) + "] from '" + _filename + "'.\n";
+                first = last;
+                break;
+            }
+
+            try
+            {
+                switch (field.type)
+                {
+                case IniFieldType::Bool:
+                    *static_cast<bool *>(field.target) = cached_bool(entry, section, field.key);
+                    break;
+                case IniFieldType::Int:
+                    *static_cast<int *>(field.target) = cached_int(entry, section, field.key);
+                    break;
+                case IniFieldType::Double:
+                    *static_cast<double *>(field.target) = cached_double(entry, section, field.key);
+                    break;
+                case IniFieldType::String:
+                    if (entry == IniTable::npos)
+                    {
+                        *static_cast<std::string *>(field.target) = read_value(section, field.key);
+                    }
+                    else
+                    {
+                        static_cast<std::string *>(field.target)->assign(_data.value(entry));
+                    }
+                    break;
+                }
+            }
+            catch (const std::runtime_error &e)
+            {
+                errors += e.what();
+                errors += '\n';
+            }
+        }
+    }
+
+    if (!errors.empty())
+    {
+        errors.pop_back();
+        throw std::runtime_error(errors);
+    }
+}
+
+/**
+ * @brief Stores a value through a handle and marks the data modified.
+ * @details An existing entry is overwritten in place; a missing key is
+ *          inserted and the handle remembers the new entry.
+ * @param handle Handle from resolve().
+ * @param value The value as text.
+ * @return The entry index in _data.
+ */
+size_t IniFile::set_value(const KeyHandle &handle, std::string_view value)
+{
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+
+    size_t entry = locate(handle);
+    if (entry == IniTable::npos)
+    {
+        entry = _data.set(handle._hash, handle._section, handle._key, value);
+        handle._entry = entry;
+        handle._generation = _generation;
+    }
+    else
+    {
+        _data.set_value(entry, value);
+    }
+    _modified = true;
+    _pending_changes = true;
+    _view_copy.reset();
+    publish();
+    return entry;
+}
+
+/**
+ * @brief Sets a string value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @param value The string value to set.
+ */
+void IniFile::set_string_value(const KeyHandle &handle, std::string_view value)
+{
+    const auto lock = write_lock();
+    set_value(handle, value);
+}
+
+/**
+ * @brief Sets a boolean value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @param value The boolean value to set.
+ */
+void IniFile::set_bool_value(const KeyHandle &handle, bool value)
+{
+    const auto lock = write_lock();
+    IniTable::Typed &typed = _data.typed(set_value(handle, bool_to_string(value)));
+    typed.as_bool = value;
+    typed.kind = IniTable::Typed::bool_value;
+}
+
+/**
+ * @brief Sets an integer value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @param value The integer value to set.
+ */
+void IniFile::set_int_value(const KeyHandle &handle, int value)
+{
+    const auto lock = write_lock();
+    IniTable::Typed &typed = _data.typed(set_value(handle, std::to_string(value)));
+    typed.as_int = value;
+    typed.kind = IniTable::Typed::int_value;
+}
+
+/**
+ * @brief Sets a double value through a resolved handle.
+ * @param handle Handle from resolve().
+ * @param value The double value to set.
+ */
+void IniFile::set_double_value(const KeyHandle &handle, double value)
+{
+    const auto lock = write_lock();
+    set_value(handle, std::to_string(value));
+}
+
+/**
+ * @brief Returns the text of an original line.
+ * @param i Zero-based line number.
+ * @return View into the source buffer, excluding the newline.
+ */
+std::string_view IniFile::line(size_t i) const
+{
+    return _source.view().substr(_lines[i].offset, _lines[i].length);
+}
+
+/**
+ * @brief Finds the section blocks of the source buffer and optionally its lines.
+ * @details Splits on '\n' with the same rules as std::getline(): a trailing
+ *          newline does not start an extra empty line. Section headers are
+ *          recognised in the same pass.
+ * @param record_lines True to rebuild _lines; otherwise _lines is cleared.
+ * @param blocks Receives the section blocks of the buffer, in file order.
+ */
+void IniFile::scan_source(bool record_lines, std::vector<SectionBlock> &blocks)
+{
+    std::string_view text = _source.view();
+    blocks.clear();
+    _lines.clear();
+    if (record_lines)
+    {
+        _lines.reserve(IniScanner::count_lines(text));
+    }
+
+    size_t line_num = 0;
+    IniScanner scanner(text);
+    IniScanner::Line span;
+    while (scanner.next(span))
+    {
+        if (span.first != IniScanner::npos && text[span.first] == '[')
+        {
+            LineToken token = tokenize(text, span);
+            if (token.kind == LineKind::Section)
+            {
+                blocks.push_back(SectionBlock{std::string(token.name), span.begin, 0, line_num, 0, 0});
+            }
+        }
+        if (record_lines)
+        {
+            _lines.push_back({span.begin, span.end - span.begin});
+        }
+        line_num++;
+    }
+
+    finish_blocks(text, line_num, blocks);
+}
+
+/**
+ * @brief Unmaps the file if it is still mapped.
+ */
+IniFile::Source::~Source()
+{
+    reset();
+}
+
+/**
+ * @brief Reads or maps a file into the buffer.
+ * @details The previous contents are kept if the file cannot be opened.
+ * @param filename Path to the file.
+ * @param map True to map a plain-text file rather than read it.
+ * @return True if the file was read, false otherwise.
+ */
+bool IniFile::Source::open(const std::string &filename, bool map)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    bool ok = false;
+    try
+    {
+        ok = read(fd, map);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    return ok;
+}
+
+/**
+ * @brief Reads or maps the rest of an open file into the buffer.
+ * @details By default the bytes are copied into an owned string: a mapping
+ *          of a file that another process truncates faults on the next
+ *          access, and entries point into this buffer for as long as the
+ *          data is loaded. When map is set, a regular plain-text file read
+ *          from offset 0 is mapped instead and kept mapped.
+ *
+ *          Otherwise a first block is read to recognize gzip and zstd by
+ *          their magic bytes. Text is then read straight into a buffer sized
+ *          from fstat(); compressed data is fed through an IniDecompressor
+ *          one block at a time, so only the decompressed text is ever held
+ *          whole. The previous contents are kept on failure.
+ * @param fd The file descriptor; it is not closed.
+ * @param map True to map a plain-text file rather than read it.
+ * @return True if the data was read, false otherwise.
+ * @throws std::runtime_error if compressed data is corrupt or its codec is
+ *         not built in.
+ */
+bool IniFile::Source::read(int fd, bool map)
+{
+    auto read_some = [fd](char *into, size_t size)
+    {
+        ssize_t n;
+        do
+        {
+            n = ::read(fd, into, size);
+        } while (n < 0 && errno == EINTR);
+        return n;
+    };
+
+    // One spare byte lets a file that did not grow finish in a single pass
+    size_t capacity = 65536;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        capacity = static_cast<size_t>(st.st_size) + 1;
+
+        if (map && ::lseek(fd, 0, SEEK_CUR) == 0)
+        {
+            const size_t size = static_cast<size_t>(st.st_size);
+            void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                const char *bytes = static_cast<const char *>(mapping);
+                const IniDecompressor::Format format = IniDecompressor::detect(std::string_view(bytes, size));
+                if (format != IniDecompressor::Format::Gzip && format != IniDecompressor::Format::Zstd)
+                {
+                    reset();
+                    _map = bytes;
+                    _map_size = size;
+                    return true;
+                }
+                // Compressed: nothing was read yet, so stream it below
+                ::munmap(mapping, size);
+            }
+        }
+    }
+
+    // A first block, only as large as needed to tell the format
+    std::string bytes(std::min(capacity, IniDecompressor::output_size), '\0');
+    size_t used = 0;
+    IniDecompressor::Format format = IniDecompressor::Format::Unknown;
+    while (format == IniDecompressor::Format::Unknown)
+    {
+        if (used == bytes.size())
+        {
+            bytes.resize(bytes.size() * 2);
+        }
+        const ssize_t n = read_some(&bytes[used], bytes.size() - used);
+        if (n < 0)
+        {
+            return false;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        used += static_cast<size_t>(n);
+        format = IniDecompressor::detect(std::string_view(bytes.data(), used));
+    }
+
+    if (format == IniDecompressor::Format::Gzip || format == IniDecompressor::Format::Zstd)
+    {
+        std::string text;
+        IniDecompressor decompressor;
+        const IniDecompressor::Sink append = [&text](std::string_view block)
+        {
+            text.append(block);
+            return true;
+        };
+        decompressor.write(std::string_view(bytes.data(), used), append);
+        for (;;)
+        {
+            const ssize_t n = read_some(&bytes[0], bytes.size());
+            if (n < 0)
+            {
+                return false;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            decompressor.write(std::string_view(bytes.data(), static_cast<size_t>(n)), append);
+        }
+        decompressor.finish(append);
+        assign(std::move(text), format);
+        return true;
+    }
+
+    // Text: read the rest into the same buffer, grown to the file size
+    bytes.resize(std::max(capacity, bytes.size()));
+    for (;;)
+    {
+        if (used == bytes.size())
+        {
+            bytes.resize(bytes.size() * 2);
+        }
+        const ssize_t n = read_some(&bytes[used], bytes.size() - used);
+        if (n < 0)
+        {
+            return false;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        used += static_cast<size_t>(n);
+    }
+    bytes.resize(used);
+    assign(std::move(bytes), format);
+    return true;
+}
+
+/**
+ * @brief Replaces the buffer with owned text.
+ * @details Anything but gzip or zstd is recorded as plain text.
+ * @param text The text to take ownership of.
+ * @param format The encoding text was decompressed from.
+ */
+void IniFile::Source::assign(std::string &&text, IniDecompressor::Format format)
+{
+    reset();
+    _owned = std::move(text);
+    _format = (format == IniDecompressor::Format::Gzip || format == IniDecompressor::Format::Zstd)
+                  ? format
+                  : IniDecompressor::Format::Plain;
+}
+
+/**
+ * @brief Exchanges the contents of two buffers.
+ */
+void IniFile::Source::swap(Source &other) noexcept
+{
+    std::swap(_map, other._map);
+    std::swap(_map_size, other._map_size);
+    _owned.swap(other._owned);
+    std::swap(_format, other._format);
+}
+
+/**
+ * @brief Frees the text, unmapping it if it was mapped.
+ */
+void IniFile::Source::reset()
+{
+    if (_map != nullptr)
+    {
+        ::munmap(const_cast<char *>(_map), _map_size);
+        _map = nullptr;
+        _map_size = 0;
+    }
+    _owned.clear();
+    _owned.shrink_to_fit();
+    _format = IniDecompressor::Format::Plain;
+}
+
+/**
+ * @brief Returns a view of the buffer contents.
+ */
+std::string_view IniFile::Source::view() const
+{
+    return (_map != nullptr) ? std::string_view(_map, _map_size) : std::string_view(_owned);
+}
+
+/**
+ * @brief Returns the encoding the text was decompressed from.
+ */
+IniDecompressor::Format IniFile::Source::format() const
+{
+    return _format;
+}
+
+/**
+ * @brief Returns the number of bytes mapped from disk, or 0.
+ */
+size_t IniFile::Source::mapped_size() const
+{
+    return _map_size;
+}
+
+/**
+ * @brief Adds the owned buffer to a tally.
+ */
+void IniFile::Source::memory_usage(IniMemoryUsage &usage) const
+{
+    usage.add(_owned);
+}
+
+/**
+ * @brief Splits a single line into its INI components.
+ * @param line The raw line, without its newline.
+ * @return The line classification and views of its parts.
+ */
+IniFile::LineToken IniFile::tokenize(std::string_view line)
+{
+    IniScanner scanner(line);
+    IniScanner::Line span;
+    if (!scanner.next(span))
+    {
+        return LineToken{LineKind::Blank, {}, {}, {}};
+    }
+    return tokenize(line, span);
+}
+
+/**
+ * @brief Builds a token from delimiter positions found by IniScanner.
+ * @details The line is trimmed first. Blank lines and lines starting with
+ *          ';' or '#' are not parsed further. `[name]` is a section header.
+ *          Otherwise the first '=' separates key and value, and anything
+ *          from the first ';' or '#' in the value onward is an inline
+ *          comment. All results are views into @p text.
+ * @param text The scanned text.
+ * @param line Delimiter positions of one line of text.
+ * @return The line classification and views into text.
+ */
+IniFile::LineToken IniFile::tokenize(std::string_view text, const IniScanner::Line &line)
+{
+    LineToken token;
+
+    if (line.first == IniScanner::npos)
+    {
+        token.kind = LineKind::Blank;
+        return token;
+    }
+
+    const char front = text[line.first];
+    if (front == ';' || front == '#')
+    {
+        token.kind = LineKind::Comment;
+        token.name = text.substr(line.first, line.last - line.first + 1);
+        return token;
+    }
+
+    if (front == '[' && text[line.last] == ']')
+    {
+        token.kind = LineKind::Section;
+        token.name = text.substr(line.first + 1, line.last - line.first - 1);
+        return token;
+    }
+
+    if (line.equals == IniScanner::npos)
+    {
+        return token;
+    }
+
+    std::string_view key = trim(text.substr(line.first, line.equals - line.first));
+
+    // Remove inline comment if present
+    size_t value_end = (line.comment != IniScanner::npos) ? line.comment : line.last + 1;
+    std::string_view value = text.substr(line.equals + 1, value_end - line.equals - 1);
+
+    if (!key.empty())
+    {
+        token.kind = LineKind::KeyValue;
+        token.key = key;
+        token.value = trim(value);
+    }
+    return token;
+}
+
+/**
+ * @brief Trims leading and trailing whitespace characters from a string.
+ * @param str The input string to be trimmed.
+ * @return A view of str with whitespace removed from both ends.
+ */
+std::string_view IniFile::trim(std::string_view str)
+{
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos)
+    {
+        return std::string_view();
+    }
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Commits any pending changes by saving the INI file.
+ * @details If there are unsaved changes, this function writes them to the file
+ *          and resets the pending changes flag.
+ */
+// cppcheck-suppress unusedFunction
+void IniFile::commit_changes()
+{
+    const auto lock = write_lock();
+    if (_pending_changes)
+    {
+        save_file();
+        _pending_changes = false;
+    }
+}
+
+/**
+ * @brief Builds a read-only copy of the current values.
+ * @details Pending lazy sections and a mapped snapshot are parsed first.
+ * @return The frozen table.
+ * @throws std::runtime_error if the data is too large to freeze.
+ */
+FrozenIni IniFile::freeze() const
+{
+    const auto lock = write_lock();
+    parse_all();
+    return FrozenIni(_data);
+}
+
+/**
+ * @brief Returns the current values as an immutable, shared snapshot.
+ * @details Writers build and publish every new snapshot themselves, so once
+ *          one exists a call is a single atomic pointer load: no lock and no
+ *          rebuild. Only the very first call, with nothing published yet,
+ *          builds one and switches publishing on.
+ * @return The latest published snapshot.
+ * @throws std::runtime_error if the data is too large to freeze.
+ */
+std::shared_ptr<const ConfigSnapshot> IniFile::snapshot() const
+{
+    std::shared_ptr<const ConfigSnapshot> current = std::atomic_load(&_published);
+    if (current)
+    {
+        return current;
+    }
+
+    // First use: start publishing, unless another thread just did
+    const auto lock = write_lock();
+    current = std::atomic_load(&_published);
+    if (!current)
+    {
+        _publishing = true;
+        publish();
+        current = std::atomic_load(&_published);
+    }
+    return current;
+}
+
+/**
+ * @brief Builds and publishes a snapshot of the current values.
+ * @details Does nothing until snapshot() has first been called. Runs on the
+ *          writer's side, under its lock, after every change. The new
+ *          snapshot is built completely before it replaces the old one,
+ *          which is freed when its last reader lets go of it. If the build
+ *          throws, the change stays in place and the old snapshot stays
+ *          published.
+ */
+void IniFile::publish() const
+{
+    if (!_publishing)
+    {
+        return;
+    }
+    parse_all();
+    std::atomic_store(&_published, std::shared_ptr<const ConfigSnapshot>(std::make_shared<ConfigSnapshot>(_data)));
+}
+
+/**
+ * @brief Lists section names in file order, without copying them.
+ * @return A range of std::string_view names.
+ */
+IniSectionView IniFile::sections() const
+{
+    const auto lock = write_lock();
+    if (_thread_safe)
+    {
+        return IniSectionView(view_copy());
+    }
+    parse_all();
+    restore_file_order();
+    return IniSectionView(_data);
+}
+
+/**
+ * @brief Lists the entries of one section in file order, without copying.
+ * @details In lazy mode only this section is parsed, unless the view needs a
+ *          thread-safe copy.
+ * @param section The section name.
+ * @return A range of IniEntry; empty if the section does not exist.
+ */
+IniKeyView IniFile::keys(std::string_view section) const
+{
+    const auto lock = write_lock();
+    if (_thread_safe)
+    {
+        std::shared_ptr<const IniTable> copy = view_copy();
+        const size_t first = copy->section_first(section);
+        return IniKeyView(std::move(copy), first);
+    }
+    if (_snapshot.is_open())
+    {
+        unpack_snapshot();
+    }
+    if (!_unparsed.empty())
+    {
+        parse_pending(section);
+    }
+    restore_file_order();
+    return IniKeyView(_data, _data.section_first(section));
+}
+
+/**
+ * @brief Lists every entry in file order, without copying.
+ * @return A range of IniEntry.
+ */
+IniEntryView IniFile::entries() const
+{
+    const auto lock = write_lock();
+    if (_thread_safe)
+    {
+        return IniEntryView(view_copy());
+    }
+    parse_all();
+    restore_file_order();
+    return IniEntryView(_data);
+}
+
+/**
+ * @brief Puts _data back in file order if reloads or lazy parsing moved it.
+ * @details Entry indices change, so key handles are invalidated.
+ */
+void IniFile::restore_file_order() const
+{
+    if (!_data.in_line_order())
+    {
+        _data.sort_by_line(_spare_data);
+        ++_generation;
+    }
+}
+
+/**
+ * @brief Finds sections whose names match a glob.
+ * @param pattern Glob over section names.
+ * @return Matching names in file order, valid until the next change.
+ */
+IniSectionMatchView IniFile::find_sections(std::string_view pattern) const
+{
+    std::vector<size_t> matches;
+    if (_thread_safe)
+    {
+        {
+            const auto lock = read_lock();
+            if (query_ready())
+            {
+                _query_index.match_sections(_data, pattern, matches);
+                return IniSectionMatchView(std::shared_ptr<const IniTable>(_view_copy, &_view_copy->table), std::move(matches));
+            }
+        }
+        const auto lock = write_lock();
+        prepare_query();
+        _query_index.match_sections(_data, pattern, matches);
+        return IniSectionMatchView(view_copy(), std::move(matches));
+    }
+
+    prepare_query();
+    _query_index.match_sections(_data, pattern, matches);
+    return IniSectionMatchView(_data, std::move(matches));
+}
+
+/**
+ * @brief Finds entries whose section and key match globs.
+ * @param section_pattern Glob over section names.
+ * @param key_pattern Glob over key names.
+ * @return Matching entries in file order, valid until the next change.
+ */
+IniEntryMatchView IniFile::find_keys(std::string_view section_pattern, std::string_view key_pattern) const
+{
+    std::vector<size_t> matches;
+    if (_thread_safe)
+    {
+        {
+            const auto lock = read_lock();
+            if (query_ready())
+            {
+                _query_index.match(_data, section_pattern, key_pattern, matches);
+                return IniEntryMatchView(std::shared_ptr<const IniTable>(_view_copy, &_view_copy->table), std::move(matches));
+            }
+        }
+        const auto lock = write_lock();
+        prepare_query();
+        _query_index.match(_data, section_pattern, key_pattern, matches);
+        return IniEntryMatchView(view_copy(), std::move(matches));
+    }
+
+    prepare_query();
+    _query_index.match(_data, section_pattern, key_pattern, matches);
+    return IniEntryMatchView(_data, std::move(matches));
+}
+
+/**
+ * @brief Parses everything and rebuilds _query_index if it is stale.
+ * @details The index holds entry indices, which stay valid until the
+ *          generation changes; keys added since are caught by the counts.
+ */
+void IniFile::prepare_query() const
+{
+    parse_all();
+    restore_file_order();
+    if (_query_generation != _generation || !_query_index.covers(_data))
+    {
+        _query_index.build(_data);
+        _query_generation = _generation;
+    }
+}
+
+/**
+ * @brief Returns true if a query can run without changing anything.
+ * @details True once prepare_query() and view_copy() have run since the
+ *          last change; find_sections() and find_keys() then need only the
+ *          shared lock.
+ */
+bool IniFile::query_ready() const
+{
+    return _view_copy && !_snapshot.is_open() && _unparsed.empty() && _data.in_line_order() &&
+           _query_generation == _generation && _query_index.covers(_data);
+}
+
+/**
+ * @brief Returns the table views read in thread-safe mode.
+ * @details Views outlive the lock, so they cannot point into _data, which
+ *          the next writer may change or free. They share a copy of _data
+ *          and of the text it points into instead; it is made on first use
+ *          after a change, in file order, so entry indices match _data.
+ *          Must be called with the exclusive lock held.
+ * @return The copy, owned jointly with every view handed out since.
+ */
+std::shared_ptr<const IniTable> IniFile::view_copy() const
+{
+    if (!_view_copy)
+    {
+        parse_all();
+        restore_file_order();
+        auto copy = std::make_shared<ViewCopy>();
+        copy->source.assign(_source.view());
+        copy->table = _data;
+        copy->table.attach(copy->source);
+        _view_copy = std::move(copy);
+    }
+    return std::shared_ptr<const IniTable>(_view_copy, &_view_copy->table);
+}
+
+/**
+ * @brief Reports the memory this object holds.
+ * @details std::map does not expose its nodes, so the size of each node of
+ *          _unparsed follows the libstdc++ layout: three links and a colour
+ *          ahead of the value. The block holding a thread-safe view copy
+ *          likewise assumes std::make_shared's vtable and two counts.
+ * @return Heap use per structure, mapped bytes and per-section figures.
+ */
+IniMemoryStats IniFile::memory_stats() const
+{
+    const auto lock = read_lock();
+    IniMemoryStats stats;
+
+    stats.lines.add(_lines);
+    stats.lines.add(_blocks);
+    stats.lines.add(_spare_blocks);
+
+    _data.memory_usage(stats.data);
+    _spare_data.memory_usage(stats.data);
+
+    _query_index.memory_usage(stats.index);
+
+    if (_view_copy)
+    {
+        stats.data.add_node(sizeof(void *) + 2 * sizeof(int) + sizeof(ViewCopy));
+        _view_copy->table.memory_usage(stats.data);
+        stats.other.add(_view_copy->source);
+    }
+
+    stats.other.add(_filename);
+    _source.memory_usage(stats.other);
+    stats.mapped = _source.mapped_size() + _snapshot.mapped_size();
+    for (const auto &pending : _unparsed)
+    {
+        stats.other.add_node(4 * sizeof(void *) + sizeof(pending));
+        stats.other.add(pending.first);
+        stats.other.add(pending.second);
+    }
+
+    stats.sections.reserve(_data.section_count());
+    for (size_t s = 0; s < _data.section_count(); ++s)
+    {
+        stats.sections.push_back(_data.section_memory(s));
+    }
+    return stats;
+}
+
+/**
+ * @brief Retrieves the parsed INI data.
+ * @details Values are stored in a flat table, so this builds the nested
+ *          map layout on each call and hands it to the caller, who owns it
+ *          and may keep it across later changes and other threads. Kept for
+ *          existing callers; the views returned by sections(), keys() and
+ *          entries() keep file order and copy nothing.
+ * @return A copy of the data.
+ */
+std::map<std::string, std::unordered_map<std::string, std::string>> IniFile::getData() const
+{
+    const auto lock = write_lock();
+    parse_all();
+
+    std::map<std::string, std::unordered_map<std::string, std::string>> data;
+    for (size_t s = 0; s < _data.section_count(); ++s)
+    {
+        auto &section = data[std::string(_data.section_name(s))];
+        for (size_t i = _data.section_first(s); i != IniTable::npos; i = _data.next_in_section(i))
+        {
+            section.emplace(_data.key(i), _data.value(i));
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Sets the internal data of the INI file.
+ *
+ * @param data A new mapping of sections to key/value pairs.
+ * @return True if the data was set successfully.
+ */
+// cppcheck-suppress unusedFunction
+void IniFile::setData(const std::map<std::string, std::unordered_map<std::string, std::string>> &data)
+{
+    const auto lock = write_lock();
+    _unparsed.clear();
+    _snapshot.close();
+    _data.clear();
+    _data.fold_case(_case_insensitive);
+    _view_copy.reset();
+    ++_generation;
+    for (const auto &section : data)
+    {
+        _data.add_section(section.first);
+        for (const auto &entry : section.second)
+        {
+            _data.set(section.first, entry.first, entry.second);
+        }
+    }
+    _modified = true;
+    publish();
+}
+
+/**
+ * @brief Default section handler; ignores the event.
+ * @return True to continue parsing.
+ */
+bool IniVisitor::on_section(std::string_view, size_t)
+{
+    return true;
+}
+
+/**
+ * @brief Default key/value handler; ignores the event.
+ * @return True to continue parsing.
+ */
+bool IniVisitor::on_key_value(std::string_view, std::string_view, std::string_view, size_t)
+{
+    return true;
+}
+
+/**
+ * @brief Default comment handler; ignores the event.
+ * @return True to continue parsing.
+ */
+bool IniVisitor::on_comment(std::string_view, size_t)
+{
+    return true;
 }
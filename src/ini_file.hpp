@@ -32,11 +32,112 @@
 #ifndef INI_FILE_HPP
 #define INI_FILE_HPP
 
+#include "frozen_ini.hpp"
+#include "ini_binding.hpp"
+#include "ini_decompressor.hpp"
+#include "ini_index.hpp"
+#include "ini_key.hpp"
+#include "ini_scanner.hpp"
+#include "ini_snapshot.hpp"
+#include "ini_table.hpp"
+#include "ini_view.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+/**
+ * @class IniVisitor
+ * @brief Receives events from IniFile::parse() as an INI file is scanned.
+ * @details Override only the callbacks of interest. Each callback returns
+ *          true to continue or false to stop parsing early. The views passed
+ *          in are only valid for the duration of the call.
+ */
+class IniVisitor
+{
+public:
+    /**
+     * @brief Default destructor.
+     */
+    virtual ~IniVisitor() = default;
+
+    /**
+     * @brief Called for each section header.
+     * @param name The section name.
+     * @param line Zero-based line number.
+     * @return True to continue parsing.
+     */
+    virtual bool on_section(std::string_view name, size_t line);
+
+    /**
+     * @brief Called for each key/value pair.
+     * @param section The enclosing section name.
+     * @param key The trimmed key.
+     * @param value The trimmed value, without any inline comment.
+     * @param line Zero-based line number.
+     * @return True to continue parsing.
+     */
+    virtual bool on_key_value(std::string_view section, std::string_view key,
+                              std::string_view value, size_t line);
+
+    /**
+     * @brief Called for each full-line comment.
+     * @param text The trimmed comment, including its ';' or '#'.
+     * @param line Zero-based line number.
+     * @return True to continue parsing.
+     */
+    virtual bool on_comment(std::string_view text, size_t line);
+};
+
+/**
+ * @class KeyHandle
+ * @brief A section and key resolved once by IniFile::resolve().
+ * @details Holds the hash of the section and key and the index of the entry
+ *          they name, so lookups through the handle neither build strings nor
+ *          hash them. The index is tagged with the generation of the data it
+ *          was found in. set_* calls never move entries, so a handle stays
+ *          valid across them; after a load, reload() or setData() the entry
+ *          is found again from the stored hash on the next use.
+ */
+class KeyHandle
+{
+public:
+    /**
+     * @brief Constructs a handle that names no key; use IniFile::resolve().
+     */
+    KeyHandle() = default;
+
+    /**
+     * @brief Returns the section name.
+     */
+    const std::string &section() const;
+
+    /**
+     * @brief Returns the key name.
+     */
+    const std::string &key() const;
+
+private:
+    friend class IniFile;
+
+    std::string _section;                   ///< Section name.
+    std::string _key;                       ///< Key name.
+    mutable uint64_t _hash = 0;             ///< IniTable::hash() of section and key.
+    mutable size_t _entry = IniTable::npos; ///< Cached entry index, or npos.
+    mutable uint64_t _generation = 0;       ///< Data generation of _entry.
+};
+
 /**
  * @class IniFile
  * @brief Handles reading and writing INI-style configuration files.
@@ -65,16 +166,221 @@ public:
 
     /**
      * @brief Loads the INI file into memory.
+     *
+     * The file is read into memory once and parsed in place; the original
+     * lines are kept as offsets into that buffer rather than copied. gzip
+     * and zstd files are recognized by their magic bytes and decompressed
+     * while loading; this applies to every load() overload and to parse().
+     *
      * @return True if the file was successfully loaded, false otherwise.
      */
     bool load();
 
+    /**
+     * @brief Loads INI text that is already in memory.
+     *
+     * The text is copied once into the source buffer. The filename is left
+     * unchanged and is still used by save().
+     *
+     * @param text The INI text.
+     * @return True if the text was successfully parsed.
+     */
+    bool load(std::string_view text);
+
+    /**
+     * @brief Loads INI text from an open file descriptor.
+     *
+     * Reading starts at the descriptor's current offset and runs to end of
+     * file, so pipes, sockets and partly-read files all work. The descriptor
+     * is not closed. The filename is left unchanged and is still used by
+     * save().
+     *
+     * @param fd A readable file descriptor.
+     * @return True if the data was successfully loaded and parsed.
+     * @throws std::runtime_error if the descriptor cannot be read.
+     */
+    bool load(int fd);
+
+    /**
+     * @brief Loads INI text from an input stream.
+     *
+     * The stream is read to its end. The filename is left unchanged and is
+     * still used by save().
+     *
+     * @param in The stream to read.
+     * @return True if the data was successfully loaded and parsed.
+     * @throws std::runtime_error if the stream fails while reading.
+     */
+    bool load(std::istream &in);
+
+    /**
+     * @brief Re-reads the INI file, re-parsing only sections that changed.
+     *
+     * Each section's bytes are hashed at load time. On reload the file is
+     * read and hashed again, and only sections whose hash differs (or that
+     * were added or removed) are re-parsed and replaced; the others keep
+     * their parsed values and just have their line numbers adjusted. If
+     * values were changed in memory since the last load or save, the whole
+     * file is re-parsed instead, as load() would.
+     *
+     * Lines before the first section header form the unnamed section "",
+     * which is listed only if it holds keys; editing a leading comment block
+     * changes nothing that can be read, so it is not reported.
+     *
+     * @return Names of the sections that were added, changed, or removed.
+     * @throws std::runtime_error if `_filename` is empty or the file cannot be opened.
+     */
+    std::vector<std::string> reload();
+
+    /**
+     * @brief Enables or disables lazy per-section parsing.
+     *
+     * In lazy mode load() only records where each section starts. A
+     * section's keys are parsed the first time it is read or written, and
+     * everything still pending is parsed by sections(), entries(),
+     * getData(), save() and commit_changes(). Takes effect at the next load.
+     *
+     * @param lazy True to parse sections on first use.
+     */
+    void set_lazy_load(bool lazy);
+
+    /**
+     * @brief Enables or disables memory-mapped loading.
+     *
+     * When enabled, load() and reload() map a plain-text file read-only
+     * instead of copying it into the heap, and entries point straight into
+     * the mapping; memory_stats() reports it under `mapped`. gzip and zstd
+     * files, descriptors not at offset 0 and anything but a regular file are
+     * still read. save() copies the text out of the mapping before it
+     * truncates the file. Takes effect at the next load.
+     *
+     * @warning The mapping follows the file on disk. If another process
+     *          truncates or rewrites the file in place while it is loaded,
+     *          later reads see the new bytes or fault with SIGBUS. Only
+     *          enable this for files that are replaced by rename, or not
+     *          changed at all, while loaded.
+     *
+     * @param mapped True to map plain-text files rather than read them.
+     */
+    void set_mmap_load(bool mapped);
+
+    /**
+     * @brief Enables or disables case-insensitive section and key names.
+     *
+     * When enabled, `[common]` and `[Common]` are the same section and
+     * `tx power` finds `TX Power`. Names are hashed case-folded at load time
+     * and by each lookup as it reads them, so lookups still take one probe
+     * and never build a lowered copy. The first spelling in the file is the
+     * one kept and written back by save(). Takes effect at the next load.
+     *
+     * @param fold True to ignore ASCII case in section and key names.
+     */
+    void set_case_insensitive(bool fold);
+
+    /**
+     * @brief Sets how many threads load() may use.
+     *
+     * Large files are split at section headers into chunks that are parsed
+     * concurrently and merged in file order, so line numbers and last-wins
+     * handling of duplicate keys match a sequential load.
+     *
+     * @param threads Worker count; 1 parses sequentially (the default) and
+     *                0 uses one thread per hardware core.
+     */
+    void set_load_threads(unsigned threads);
+
+    /**
+     * @brief Enables or disables locking for use from several threads.
+     *
+     * In thread-safe mode every call takes a reader/writer lock. Reads of
+     * single values (get_*, get(), bind(), resolve()) share the lock and run
+     * in parallel; everything that may change or reorder the data takes it
+     * exclusively. Lazy loading still only scans the file, but every pending
+     * section is parsed when this mode is switched on and at the end of each
+     * load, so no read has to parse one.
+     *
+     * The typed-value cache is off in this mode: concurrent readers share
+     * each entry, so get_int_value(), get_double_value(), get_bool_value()
+     * and get() convert the stored text on every call unless the value was
+     * stored by a set_* call. Expect typed reads to be slower per call than
+     * in single-threaded use.
+     *
+     * Views from sections(), keys(), entries() and the find_* queries
+     * outlive the lock, so in this mode they read a copy of the data and
+     * its text instead, which they keep alive. The copy is made on the first
+     * view after a change and shared by every view until the next one. The
+     * find_* queries share the lock while that copy and the query index are
+     * current, and take it exclusively to rebuild them. A KeyHandle caches
+     * its entry, so each thread should resolve its own. Switch modes before
+     * other threads start using the object: calls already running when the
+     * mode changes do not hold the lock.
+     *
+     * @param enabled True to lock every call.
+     */
+    void set_thread_safe(bool enabled);
+
+    /**
+     * @brief Streams an INI file through a visitor without storing it.
+     *
+     * The file is read in fixed-size blocks and parsed with the same
+     * tokenizer as load(), so memory use does not grow with file size.
+     * Nothing is added to this object's data.
+     *
+     * @param filename Path to the INI file.
+     * @param visitor Receives the parse events.
+     * @return True if the whole file was parsed, false if the visitor stopped early.
+     * @throws std::runtime_error if the file cannot be opened or read.
+     */
+    static bool parse(const std::string &filename, IniVisitor &visitor);
+
+    /**
+     * @brief Streams INI text already in memory through a visitor.
+     * @param text The INI text.
+     * @param visitor Receives the parse events.
+     * @return True if all text was parsed, false if the visitor stopped early.
+     */
+    static bool parse_buffer(std::string_view text, IniVisitor &visitor);
+
     /**
      * @brief Saves the current data to the INI file.
+     *
+     * Data that was loaded from gzip or zstd is compressed again, so the
+     * file keeps its format; this throws if that codec is not built in.
+     *
      * @return True if the file was successfully saved, false otherwise.
+     * @throws std::runtime_error if the file cannot be written or compressed.
      */
     bool save();
 
+    /**
+     * @brief Writes the parsed data to a binary snapshot (.inib) file.
+     *
+     * The snapshot records the size and hash of the INI text it was built
+     * from. It is written to a temporary file and renamed into place, so
+     * processes that have the old snapshot mapped are not disturbed.
+     *
+     * @param path Path of the snapshot file.
+     * @return True if the snapshot was written.
+     * @throws std::runtime_error if there are unsaved changes or the file cannot be written.
+     */
+    bool save_snapshot(const std::string &path);
+
+    /**
+     * @brief Sets the filename and loads it from a snapshot if possible.
+     *
+     * The INI file is read and hashed but not parsed; if the snapshot was
+     * built from identical text, lookups are served straight from the mapped
+     * snapshot. The first change, getData(), save() or reload() unpacks it
+     * into the usual maps. A missing, stale or incompatible snapshot is
+     * ignored and the INI file is parsed with load() instead.
+     *
+     * @param filename Path to the INI file.
+     * @param path Path of the snapshot file.
+     * @return True if the snapshot was used, false if the file was parsed.
+     * @throws std::runtime_error if the INI file cannot be opened.
+     */
+    bool load_snapshot(const std::string &filename, const std::string &path);
+
     /**
      * @brief Retrieves a string value from the INI file.
      * @param section The section name.
@@ -82,27 +388,92 @@ public:
      * @return The corresponding value as a string.
      * @throws std::runtime_error if the section or key is not found.
      */
-    std::string get_value(const std::string &section, const std::string &key) const;
+    std::string get_value(std::string_view section, std::string_view key) const;
 
     /**
      * @brief Retrieves a string value with an optional default.
      */
-    std::string get_string_value(const std::string &section, const std::string &key) const;
+    std::string get_string_value(std::string_view section, std::string_view key) const;
 
     /**
      * @brief Retrieves a boolean value with an optional default.
      */
-    bool get_bool_value(const std::string &section, const std::string &key) const;
+    bool get_bool_value(std::string_view section, std::string_view key) const;
 
     /**
      * @brief Retrieves an integer value with an optional default.
      */
-    int get_int_value(const std::string &section, const std::string &key) const;
+    int get_int_value(std::string_view section, std::string_view key) const;
 
     /**
      * @brief Retrieves a double value with an optional default.
      */
-    double get_double_value(const std::string &section, const std::string &key) const;
+    double get_double_value(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Resolves a section and key to a handle for repeated access.
+     * @details The key does not have to exist yet; a handle to a missing key
+     *          throws on get_* and creates the key on set_*.
+     * @param section The section name.
+     * @param key The key name.
+     * @return A handle usable with the get_* and set_* overloads.
+     */
+    KeyHandle resolve(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Retrieves a string value through a resolved handle.
+     * @param handle Handle from resolve().
+     * @return The corresponding value as a string.
+     * @throws std::runtime_error if the section or key is not found.
+     */
+    std::string get_value(const KeyHandle &handle) const;
+
+    /**
+     * @brief Retrieves a string value through a resolved handle.
+     */
+    std::string get_string_value(const KeyHandle &handle) const;
+
+    /**
+     * @brief Retrieves a boolean value through a resolved handle.
+     */
+    bool get_bool_value(const KeyHandle &handle) const;
+
+    /**
+     * @brief Retrieves an integer value through a resolved handle.
+     */
+    int get_int_value(const KeyHandle &handle) const;
+
+    /**
+     * @brief Retrieves a double value through a resolved handle.
+     */
+    double get_double_value(const KeyHandle &handle) const;
+
+    /**
+     * @brief Retrieves a value through a typed key.
+     * @details The key's hash was computed at compile time and its type
+     *          selects the conversion, so the lookup does no hashing and no
+     *          type dispatch. Typed values use the same cache as get_*.
+     * @param key A key, usually declared constexpr.
+     * @return The value converted to T.
+     * @throws std::runtime_error if the section or key is not found, or if
+     *         the value cannot be converted.
+     */
+    template <typename T>
+    T get(const IniKey<T> &key) const;
+
+    /**
+     * @brief Reads a list of fields into their members.
+     * @details Fields of one section must be adjacent, so that a missing
+     *          section is reported once. Each key is found from its
+     *          precomputed hash. Every field that can be read is stored;
+     *          the rest are reported together. Use the bind() template
+     *          rather than calling this directly.
+     * @param fields The fields, grouped by section.
+     * @param count Number of fields.
+     * @throws std::runtime_error listing every missing section or key and
+     *         every value that does not convert, one per line.
+     */
+    void bind(const IniBoundField *fields, size_t count) const;
 
     /**
      * @brief Sets a string value in the INI file.
@@ -114,9 +485,9 @@ public:
      * @param key      The key within the section.
      * @param value    The string value to assign to the key.
      */
-    void set_string_value(const std::string &section,
-                          const std::string &key,
-                          const std::string &value);
+    void set_string_value(std::string_view section,
+                          std::string_view key,
+                          std::string_view value);
 
     /**
      * @brief Sets a boolean value in the INI file.
@@ -128,8 +499,8 @@ public:
      * @param key      The key within the section.
      * @param value    The boolean value to assign to the key.
      */
-    void set_bool_value(const std::string &section,
-                        const std::string &key,
+    void set_bool_value(std::string_view section,
+                        std::string_view key,
                         bool value);
 
     /**
@@ -142,8 +513,8 @@ public:
      * @param key      The key within the section.
      * @param value    The integer value to assign to the key.
      */
-    void set_int_value(const std::string &section,
-                       const std::string &key,
+    void set_int_value(std::string_view section,
+                       std::string_view key,
                        int value);
 
     /**
@@ -156,10 +527,62 @@ public:
      * @param key      The key within the section.
      * @param value    The double value to assign to the key.
      */
-    void set_double_value(const std::string &section,
-                          const std::string &key,
+    void set_double_value(std::string_view section,
+                          std::string_view key,
                           double value);
 
+    /**
+     * @brief Sets a string value through a resolved handle.
+     * @param handle Handle from resolve().
+     * @param value The string value to assign to the key.
+     */
+    void set_string_value(const KeyHandle &handle, std::string_view value);
+
+    /**
+     * @brief Sets a boolean value through a resolved handle.
+     */
+    void set_bool_value(const KeyHandle &handle, bool value);
+
+    /**
+     * @brief Sets an integer value through a resolved handle.
+     */
+    void set_int_value(const KeyHandle &handle, int value);
+
+    /**
+     * @brief Sets a double value through a resolved handle.
+     */
+    void set_double_value(const KeyHandle &handle, double value);
+
+    /**
+     * @brief Builds a read-only copy of the current values.
+     * @details The copy is indexed by a minimal perfect hash, so each lookup
+     *          costs one hash and one compare. It does not see later changes.
+     * @return The frozen table.
+     * @throws std::runtime_error if the data is too large to freeze.
+     */
+    FrozenIni freeze() const;
+
+    /**
+     * @brief Returns the current values as an immutable, shared snapshot.
+     *
+     * Readers can keep the snapshot and query it from any thread without
+     * locks; it never changes. The first call builds one, and from then on
+     * every set_*, load, reload() and setData() builds a new snapshot and
+     * swaps it in atomically, on the writer's side. Later calls are a
+     * single atomic pointer load that never waits for a writer or a reload
+     * to finish. An old snapshot is freed when the last reader drops it.
+     * With snapshots in use each change rebuilds the whole table, so batch
+     * writes through setData() where that matters, and lazy sections are
+     * parsed as soon as anything changes.
+     *
+     * Call it once before readers start, or use thread-safe mode, so that
+     * the first build does not race a writer.
+     *
+     * @return The latest published snapshot.
+     * @throws std::runtime_error if the data is too large to freeze.
+     */
+    std::shared_ptr<const ConfigSnapshot> snapshot() const;
+
     /**
      * @brief Commits any pending changes to the INI file.
      */
@@ -167,9 +590,82 @@ public:
 
     /**
      * @brief Retrieves the parsed INI data.
-     * @return A const reference to the internal data storage.
+     * @deprecated Builds a nested copy of every key and value on each call
+     *             and loses key order; use sections(), keys() or entries().
+     *             A later release will mark it `[[deprecated]]`.
+     * @return A copy of the data, owned by the caller.
+     */
+    std::map<std::string, std::unordered_map<std::string, std::string>> getData() const;
+
+    /**
+     * @brief Lists section names in file order, without copying them.
+     *
+     * Sections created in memory follow those read from the file. Like
+     * every view, the result is valid until the IniFile is next changed or
+     * loaded. In lazy mode all pending sections are parsed first.
+     *
+     * @return A range of std::string_view names.
+     */
+    IniSectionView sections() const;
+
+    /**
+     * @brief Lists the entries of one section in file order, without copying.
+     *
+     * A key repeated in the file appears once, where its winning line is.
+     * In lazy mode only this section is parsed, except in thread-safe mode,
+     * where the view's copy needs every section.
+     *
+     * @param section The section name.
+     * @return A range of IniEntry; empty if the section does not exist.
+     */
+    IniKeyView keys(std::string_view section) const;
+
+    /**
+     * @brief Lists every entry in file order, without copying.
+     *
+     * A single linear pass over the contiguous entry table, section after
+     * section, which makes it the fastest way to dump a whole config.
+     *
+     * @return A range of IniEntry.
+     */
+    IniEntryView entries() const;
+
+    /**
+     * @brief Finds sections whose names match a glob.
+     *
+     * `*` matches any run of characters and `?` any one character, so
+     * `Server*` finds every section starting with "Server". Queries use a
+     * sorted index built on first use and kept until entries are added,
+     * removed or reordered, and take O(log n + matches).
+     *
+     * @param pattern Glob over section names.
+     * @return Matching names in file order, valid until the next change.
+     */
+    IniSectionMatchView find_sections(std::string_view pattern) const;
+
+    /**
+     * @brief Finds entries whose section and key match globs.
+     *
+     * `find_keys("Server*")` returns every key of the matching sections and
+     * `find_keys("*", "LED*")` every key starting with "LED" in any section.
+     *
+     * @param section_pattern Glob over section names.
+     * @param key_pattern Glob over key names.
+     * @return Matching entries in file order, valid until the next change.
      */
-    const std::map<std::string, std::unordered_map<std::string, std::string>> &getData() const;
+    IniEntryMatchView find_keys(std::string_view section_pattern, std::string_view key_pattern = "*") const;
+
+    /**
+     * @brief Reports the memory this object holds.
+     *
+     * Every live heap block behind the line index, the key table, the query
+     * index and the remaining buffers is counted, and the allocator is asked
+     * for each block's real size, so the figures include its rounding and
+     * headers. Sections not yet parsed in lazy mode hold no entries.
+     *
+     * @return Heap use per structure, mapped bytes and per-section figures.
+     */
+    IniMemoryStats memory_stats() const;
 
     /**
      * @brief Sets the internal data of the INI file.
@@ -180,6 +676,8 @@ public:
     void setData(const std::map<std::string, std::unordered_map<std::string, std::string>> &data);
 
 private:
+    friend class FrozenIni;
+
     /**
      * @brief Default constructor.
      *
@@ -226,6 +724,156 @@ private:
      */
     IniFile &operator=(IniFile &&) = delete;
 
+    /**
+     * @class Source
+     * @brief Buffer holding the raw bytes of the loaded INI file.
+     * @details Files are read into an owned string by default, so rewriting
+     *          or truncating the file on disk cannot disturb the entries
+     *          that point into it. With mapping enabled a plain-text file is
+     *          mapped instead and stays mapped until the buffer is replaced.
+     *          Callers only see a string_view.
+     */
+    class Source
+    {
+    public:
+        Source() = default;
+        ~Source();
+        Source(const Source &) = delete;
+        Source &operator=(const Source &) = delete;
+
+        /**
+         * @brief Reads or maps a file into the buffer.
+         * @param filename Path to the file.
+         * @param map True to map a plain-text file rather than read it.
+         * @return False if the file cannot be opened.
+         */
+        bool open(const std::string &filename, bool map = false);
+
+        /**
+         * @brief Reads or maps the rest of an open file into the buffer.
+         * @param fd The file descriptor; it is not closed.
+         * @param map True to map a plain-text file rather than read it.
+         * @return False if reading fails.
+         */
+        bool read(int fd, bool map = false);
+
+        /**
+         * @brief Replaces the buffer with an owned copy of text.
+         * @param text The text to take ownership of.
+         * @param format The encoding text was decompressed from.
+         */
+        void assign(std::string &&text, IniDecompressor::Format format = IniDecompressor::Format::Plain);
+
+        /**
+         * @brief Releases the text, unmapping it if it was mapped.
+         */
+        void reset();
+
+        /**
+         * @brief Exchanges the contents of two buffers.
+         */
+        void swap(Source &other) noexcept;
+
+        /**
+         * @brief Returns a view of the buffer contents.
+         */
+        std::string_view view() const;
+
+        /**
+         * @brief Returns the encoding the text was decompressed from.
+         */
+        IniDecompressor::Format format() const;
+
+        /**
+         * @brief Returns the number of bytes mapped from disk, or 0.
+         */
+        size_t mapped_size() const;
+
+        /**
+         * @brief Adds the owned buffer to a tally.
+         * @param usage The tally to add to.
+         */
+        void memory_usage(IniMemoryUsage &usage) const;
+
+    private:
+        const char *_map = nullptr;                                          ///< Start of the mapped file, if mapped.
+        size_t _map_size = 0;                                                ///< Length of the mapping.
+        std::string _owned;                                                  ///< The file's bytes, decompressed if need be.
+        IniDecompressor::Format _format = IniDecompressor::Format::Plain; ///< Encoding on disk.
+    };
+
+    /**
+     * @brief Location of one original line within the source buffer.
+     */
+    struct LineSpan
+    {
+        size_t offset; ///< Byte offset of the first character.
+        size_t length; ///< Length in bytes, excluding the newline.
+    };
+
+    /**
+     * @brief Kinds of line recognised by the tokenizer.
+     */
+    enum class LineKind
+    {
+        Blank,    ///< Empty or whitespace-only line.
+        Comment,  ///< Full-line comment starting with ';' or '#'.
+        Section,  ///< Section header such as `[name]`.
+        KeyValue, ///< `key = value` pair with a non-empty key.
+        Other     ///< Anything else; preserved but not parsed.
+    };
+
+    /**
+     * @brief Result of tokenizing one line.
+     *
+     * All views point into the line that was tokenized; nothing is copied.
+     */
+    struct LineToken
+    {
+        LineKind kind = LineKind::Other; ///< Line classification.
+        std::string_view name;           ///< Section name, or the comment text for Comment lines.
+        std::string_view key;            ///< Trimmed key for KeyValue lines.
+        std::string_view value;          ///< Trimmed value, inline comment removed.
+    };
+
+    /**
+     * @brief One contiguous run of lines belonging to a section.
+     *
+     * A block starts at a section header and runs to the next header. Lines
+     * before the first header form a block of the unnamed section. A section
+     * repeated in the file has one block per header.
+     */
+    struct SectionBlock
+    {
+        std::string name;      ///< Section name.
+        size_t begin = 0;      ///< Byte offset of the first line.
+        size_t end = 0;        ///< Byte offset one past the last line.
+        size_t first_line = 0; ///< Line number of the first line.
+        size_t line_count = 0; ///< Number of lines in the block.
+        uint64_t hash = 0;     ///< Hash of the block's bytes.
+    };
+
+    /**
+     * @brief Slice of the source buffer parsed by one load() worker.
+     *
+     * Every chunk after the first starts on a section header, so each can be
+     * parsed without knowing what came before it.
+     */
+    struct Chunk
+    {
+        size_t begin = 0;      ///< Byte offset of the first line.
+        size_t end = 0;        ///< Byte offset one past the last line.
+        size_t first_line = 0; ///< Line number of the first line.
+        size_t line_count = 0; ///< Number of lines in the chunk.
+        IniTable table;                   ///< Parsed values and their line numbers.
+        std::vector<SectionBlock> blocks; ///< Headers found, in order.
+    };
+
+    /**
+     * @brief Smallest chunk worth handing to a separate load() worker.
+     */
+    static constexpr size_t min_chunk_size = 256 * 1024;
+
     /**
      * @brief Path to the INI configuration file.
      *
@@ -236,38 +884,425 @@ private:
     /**
      * @brief Internal data storage.
      *
-     * Maps each section name to a map of key/value string pairs.
+     * Flat table of section/key/value entries, each with the line it was
+     * read from. Parsed keys and values are offsets into _source; only
+     * section names and values set in memory are copied. Mutable because
+     * lazy mode fills sections in from const accessors.
+     */
+    mutable IniTable _data;
+
+    /**
+     * @brief Buffers reused by reload() and the views when they rebuild _data.
+     */
+    mutable IniTable _spare_data;
+
+    /**
+     * @brief Sorted names of _data for find_sections() and find_keys().
+     */
+    mutable IniIndex _query_index;
+
+    /**
+     * @brief Value of _generation when _query_index was built; 0 if never.
+     */
+    mutable uint64_t _query_generation = 0;
+
+    /**
+     * @struct ViewCopy
+     * @brief Detached copy of _data and the text it points into.
+     */
+    struct ViewCopy
+    {
+        std::string source; ///< Copy of the source text.
+        IniTable table;     ///< Copy of _data, attached to source.
+    };
+
+    /**
+     * @brief Copy handed to views in thread-safe mode; reset on every change.
+     */
+    mutable std::shared_ptr<const ViewCopy> _view_copy;
+
+    /**
+     * @brief Raw bytes of the loaded INI file.
+     *
+     * Owns the bytes that the entries in _lines and _data point into.
      */
-    std::map<std::string, std::unordered_map<std::string, std::string>> _data;
+    Source _source;
 
     /**
      * @brief Original file lines.
      *
-     * Stores every line from the INI file, including comments and blank lines,
-     * to allow preservation of formatting on save().
+     * Records every line from the INI file, including comments and blank lines,
+     * as an offset into _source to allow preservation of formatting on save().
+     */
+    std::vector<LineSpan> _lines;
+
+    /**
+     * @brief Number of threads load() may use; 0 means one per core.
+     */
+    unsigned _load_threads = 1;
+
+    /**
+     * @brief Section blocks of _source, in file order, for reload().
+     */
+    std::vector<SectionBlock> _blocks;
+
+    /**
+     * @brief Buffers reused by reload() for the next set of section blocks.
+     */
+    std::vector<SectionBlock> _spare_blocks;
+
+    /**
+     * @brief True if values were changed in memory since the last load or save.
+     */
+    bool _modified = false;
+
+    /**
+     * @brief True if sections are parsed on first use.
+     */
+    bool _lazy = false;
+
+    /**
+     * @brief True if plain-text files are mapped rather than read.
+     */
+    bool _mmap = false;
+
+    /**
+     * @brief True if section and key names ignore ASCII case.
+     */
+    bool _case_insensitive = false;
+
+    /**
+     * @brief Orders section names, optionally ignoring ASCII case.
+     */
+    struct NameLess
+    {
+        using is_transparent = void; ///< Allows lookups by std::string_view.
+        bool fold = false;           ///< True to ignore ASCII case.
+
+        /**
+         * @brief Returns true if a sorts before b.
+         */
+        bool operator()(std::string_view a, std::string_view b) const;
+    };
+
+    /**
+     * @brief Sections not parsed yet in lazy mode.
+     *
+     * Maps each section name to the indices of its blocks in _blocks, with
+     * names compared the way _data compares them.
+     */
+    mutable std::map<std::string, std::vector<size_t>, NameLess> _unparsed;
+
+    /**
+     * @brief Snapshot serving lookups after load_snapshot().
+     *
+     * While open, _data, _lines and _blocks are empty.
      */
-    std::vector<std::string> _lines;
+    mutable IniSnapshot _snapshot;
 
     /**
-     * @brief Fast lookup index.
+     * @brief Generation of _data, for validating KeyHandle indices.
      *
-     * Maps section/key pairs to their line number in _lines for in-place edits.
+     * Advanced whenever entries may move: on load, reload(), setData() and
+     * when a snapshot is unpacked or replaced.
+     */
+    mutable uint64_t _generation = 1;
+
+    /**
+     * @brief True to lock every call; see set_thread_safe().
+     */
+    std::atomic<bool> _thread_safe{false};
+
+    /**
+     * @brief Reader/writer lock used in thread-safe mode.
+     */
+    mutable std::shared_mutex _mutex;
+
+    /**
+     * @brief True while set_* changes await commit_changes().
+     */
+    std::atomic<bool> _pending_changes{false};
+
+    /**
+     * @brief True once snapshot() has been called and changes are published.
+     */
+    mutable std::atomic<bool> _publishing{false};
+
+    /**
+     * @brief Latest snapshot; only accessed through std::atomic_load/store.
+     */
+    mutable std::shared_ptr<const ConfigSnapshot> _published;
+
+    /**
+     * @brief Returns the text of an original line.
+     * @param i Zero-based line number.
+     * @return View into _source, excluding the newline.
+     */
+    std::string_view line(size_t i) const;
+
+    /**
+     * @brief Parses the contents of _source into _data and _lines.
+     * @return True once parsed.
+     */
+    bool parse_source();
+
+    /**
+     * @brief Finds the section blocks of _source and optionally its lines.
+     * @param record_lines True to rebuild _lines; otherwise _lines is cleared.
+     * @param blocks Receives the section blocks, in file order.
+     */
+    void scan_source(bool record_lines, std::vector<SectionBlock> &blocks);
+
+    /**
+     * @brief Splits text into at most count chunks at section headers.
+     * @param text The text to split.
+     * @param count The desired number of chunks.
+     * @return Chunks covering text in order; at least one.
+     */
+    static std::vector<Chunk> split_chunks(std::string_view text, size_t count);
+
+    /**
+     * @brief Parses one chunk into its own maps and, optionally, its lines.
+     * @param text The full source text.
+     * @param chunk The chunk to parse; first_line must already be set.
+     * @param lines Where to record the chunk's lines, or nullptr.
+     */
+    static void parse_chunk(std::string_view text, Chunk &chunk, LineSpan *lines);
+
+    /**
+     * @brief Merges parsed chunks into _data.
+     * @details Chunks are applied in file order and each overwrites earlier
+     *          duplicates, so the entry that appears later in the file wins.
+     *          While _data is still empty the chunk's table is moved in whole
+     *          instead of copied.
+     * @param chunks Parsed chunks in file order; their tables are cleared.
+     */
+    void merge_chunks(std::vector<Chunk> &chunks) const;
+
+    /**
+     * @brief Parses a section that lazy mode has not parsed yet.
+     * @param section The section name; nothing happens if it is parsed.
+     */
+    void parse_pending(std::string_view section) const;
+
+    /**
+     * @brief Parses every section lazy mode has not parsed yet.
+     */
+    void parse_all() const;
+
+    /**
+     * @brief Returns true if lines before the first header hold keys.
+     */
+    bool unnamed_keys() const;
+
+    /**
+     * @brief Copies the mapped snapshot into _data and closes it.
+     */
+    void unpack_snapshot() const;
+
+    /**
+     * @brief Puts _data back in file order if reloads or lazy parsing moved it.
+     */
+    void restore_file_order() const;
+
+    /**
+     * @brief Parses everything and rebuilds _query_index if it is stale.
+     */
+    void prepare_query() const;
+
+    /**
+     * @brief Returns true if a query can run without changing anything.
+     */
+    bool query_ready() const;
+
+    /**
+     * @brief Returns the table views read in thread-safe mode.
+     */
+    std::shared_ptr<const IniTable> view_copy() const;
+
+    /**
+     * @brief Completes blocks that only have their start recorded.
+     * @details Adds the unnamed leading block if there are lines before the
+     *          first header, then fills in each block's end, line count and
+     *          hash.
+     * @param text The INI text.
+     * @param total_lines Number of lines in text.
+     * @param blocks Blocks with name, begin and first_line set, in order.
+     */
+    static void finish_blocks(std::string_view text, size_t total_lines, std::vector<SectionBlock> &blocks);
+
+    /**
+     * @brief Hashes a byte range for change detection.
+     * @param bytes The bytes to hash.
+     * @return A 64-bit hash; not suitable for untrusted input.
      */
-    std::map<std::string, std::map<std::string, size_t>> _index;
+    static uint64_t hash_bytes(std::string_view bytes);
+
+    /**
+     * @brief Splits a single line into its INI components.
+     * @param line The raw line, without its newline.
+     * @return The line classification and views of its parts.
+     */
+    static LineToken tokenize(std::string_view line);
+
+    /**
+     * @brief Builds a token from delimiter positions found by IniScanner.
+     * @param text The scanned text.
+     * @param line Delimiter positions of one line of text.
+     * @return The line classification and views into text.
+     */
+    static LineToken tokenize(std::string_view text, const IniScanner::Line &line);
+
+    /**
+     * @brief Parser state carried between blocks by parse().
+     */
+    struct VisitState
+    {
+        IniVisitor &visitor;  ///< Receives the events.
+        std::string section;  ///< Current section name.
+        size_t line_num = 0;  ///< Number of the next line.
+    };
+
+    /**
+     * @brief Parses complete lines of text and reports them to a visitor.
+     * @param text Whole lines; the last may lack its newline.
+     * @param state Visitor and state carried from earlier text.
+     * @return False if the visitor asked to stop.
+     */
+    static bool visit_lines(std::string_view text, VisitState &state);
 
     /**
      * @brief Trims whitespace from a string.
      * @param str The string to trim.
-     * @return Trimmed string.
+     * @return View of str without leading and trailing whitespace.
+     */
+    static std::string_view trim(std::string_view str);
+
+    /**
+     * @brief Finds the entry of a handle, refreshing its cached index.
+     * @param handle Handle from resolve().
+     * @return The entry index in _data, or IniTable::npos if the key is
+     *         missing or a snapshot is serving lookups.
+     */
+    size_t locate(const KeyHandle &handle) const;
+
+    /**
+     * @brief Stores a value through a handle and marks the data modified.
+     * @param handle Handle from resolve().
+     * @param value The value as text.
+     * @return The entry index in _data.
+     */
+    size_t set_value(const KeyHandle &handle, std::string_view value);
+
+    /**
+     * @brief Finds the entry for a section and key in _data.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The entry index, or IniTable::npos if the key is missing or a
+     *         snapshot is serving lookups.
+     */
+    size_t lookup(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Finds the entry for a section and key from a precomputed hash.
+     * @param hash IniHash::key() of section and key, folded if _data folds case.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The entry index, or IniTable::npos if the key is missing or a
+     *         snapshot is serving lookups.
+     */
+    size_t lookup(uint64_t hash, std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Takes the shared lock in thread-safe mode.
+     * @return The held lock, or an empty one outside thread-safe mode.
+     */
+    std::shared_lock<std::shared_mutex> read_lock() const;
+
+    /**
+     * @brief Takes the exclusive lock in thread-safe mode.
+     * @return The held lock, or an empty one outside thread-safe mode.
+     */
+    std::unique_lock<std::shared_mutex> write_lock() const;
+
+    /**
+     * @brief Retrieves a value as a string, without locking.
+     * @throws std::runtime_error if the section or key is not found.
+     */
+    std::string read_value(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Retrieves a value through a resolved handle, without locking.
+     * @throws std::runtime_error if the section or key is not found.
+     */
+    std::string read_value(const KeyHandle &handle) const;
+
+    /**
+     * @brief Reads and parses the file named by _filename, without locking.
+     * @return True once parsed.
+     */
+    bool load_file();
+
+    /**
+     * @brief Writes the file named by _filename, without locking.
+     * @return True if the file was saved.
+     */
+    bool save_file();
+
+    /**
+     * @brief Builds and publishes a snapshot once snapshot() is in use.
+     */
+    void publish() const;
+
+    /**
+     * @brief Returns an entry as an integer, parsing it only on first use.
+     * @param entry Entry index in _data, or IniTable::npos to look up by name.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The integer value.
+     * @throws std::runtime_error if the key is not found or is not a valid integer.
+     */
+    int cached_int(size_t entry, std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Returns an entry as a double, parsing it only on first use.
+     * @param entry Entry index in _data, or IniTable::npos to look up by name.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The double value.
+     * @throws std::runtime_error if the key is not found or is not a valid double.
+     */
+    double cached_double(size_t entry, std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Returns an entry as a boolean, parsing it only on first use.
+     * @param entry Entry index in _data, or IniTable::npos to look up by name.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The boolean value.
+     * @throws std::runtime_error if the key is not found.
+     */
+    bool cached_bool(size_t entry, std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Converts a stored value to an integer.
+     * @param value The stored value.
+     * @param section The section name, for error messages.
+     * @param key The key name, for error messages.
+     * @return The integer value.
+     * @throws std::runtime_error if the value is not a valid integer.
      */
-    static std::string trim(const std::string &str);
+    static int to_int(const std::string &value, std::string_view section, std::string_view key);
 
     /**
-     * @brief Determines if a line is a comment.
-     * @param line The line to check.
-     * @return True if the line is a comment, false otherwise.
+     * @brief Converts a stored value to a double.
+     * @param value The stored value.
+     * @param section The section name, for error messages.
+     * @param key The key name, for error messages.
+     * @return The double value.
+     * @throws std::runtime_error if the value is not a valid double.
      */
-    static bool is_comment(const std::string &line);
+    static double to_double(const std::string &value, std::string_view section, std::string_view key);
 
     /**
      * @brief Converts a boolean value to string.
@@ -281,7 +1316,57 @@ private:
      * @param value The string to convert.
      * @return True if the string represents a true value, false otherwise.
      */
-    static bool string_to_bool(const std::string &value);
+    static bool string_to_bool(std::string_view value);
 };
 
+/**
+ * @brief Retrieves a value through a typed key.
+ */
+template <typename T>
+T IniFile::get(const IniKey<T> &key) const
+{
+    const auto lock = read_lock();
+    const size_t entry = lookup(key.hash(_data.folds_case()), key.section(), key.key());
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        return cached_bool(entry, key.section(), key.key());
+    }
+    else if constexpr (std::is_same<T, int>::value)
+    {
+        return cached_int(entry, key.section(), key.key());
+    }
+    else if constexpr (std::is_same<T, double>::value)
+    {
+        return cached_double(entry, key.section(), key.key());
+    }
+    else
+    {
+        return (entry == IniTable::npos) ? read_value(key.section(), key.key()) : std::string(_data.value(entry));
+    }
+}
+
+/**
+ * @brief Fills a struct from its IniBinding field table.
+ * @details The table is grouped by section at compile time, so the whole
+ *          struct is read in one pass with one check per section.
+ * @tparam T A struct with an IniBinding<T> specialization.
+ * @param config The configuration to read.
+ * @param object The struct to fill; fields that cannot be read keep their
+ *        previous values.
+ * @throws std::runtime_error listing every field that could not be read.
+ */
+template <typename T>
+void bind(const IniFile &config, T &object)
+{
+    constexpr auto &fields = IniBinding<T>::fields;
+    static constexpr auto order = IniField<T>::section_order(fields);
+
+    std::array<IniBoundField, order.size()> bound{};
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        bound[i] = fields[order[i]].on(object);
+    }
+    config.bind(bound.data(), bound.size());
+}
+
 #endif // INI_FILE_HPP
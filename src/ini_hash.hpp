@@ -0,0 +1,154 @@
+/**
+ * @file ini_hash.hpp
+ * @brief Hash of a section/key pair shared by the INI lookup tables.
+ * @details The hash is constexpr so that tables written to disk, tables
+ *          built at runtime and keys hashed at compile time all agree.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_HASH_HPP
+#define INI_HASH_HPP
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @class IniHash
+ * @brief 64-bit FNV-1a over a section name and, optionally, a key.
+ * @details A 0xff byte, which never occurs in UTF-8 text, separates the two
+ *          parts so that ("ab", "c") and ("a", "bc") hash differently. The
+ *          high bits are folded into the low ones at the end because tables
+ *          index buckets with the low bits.
+ *
+ *          With fold set, ASCII letters are hashed as lower case as they are
+ *          read, so case-insensitive lookups never build a lowered copy;
+ *          equal() and less() compare names under the same rule.
+ */
+class IniHash
+{
+public:
+    /**
+     * @brief Hashes a section name on its own.
+     * @param section The section name.
+     * @param fold True to ignore ASCII case.
+     * @return The 64-bit hash.
+     */
+    static constexpr uint64_t section(std::string_view section, bool fold = false)
+    {
+        const uint64_t h = append(offset_basis, section, fold);
+        return h ^ (h >> 29);
+    }
+
+    /**
+     * @brief Hashes a section/key pair.
+     * @param section The section name.
+     * @param key The key name.
+     * @param fold True to ignore ASCII case.
+     * @return The 64-bit hash.
+     */
+    static constexpr uint64_t key(std::string_view section, std::string_view key, bool fold = false)
+    {
+        uint64_t h = append(offset_basis, section, fold);
+        h = (h ^ 0xff) * prime;
+        h = append(h, key, fold);
+        return h ^ (h >> 29);
+    }
+
+    /**
+     * @brief Compares two names the way hashes with the same fold flag do.
+     * @param a The first name.
+     * @param b The second name.
+     * @param fold True to ignore ASCII case.
+     * @return True if the names match.
+     */
+    static constexpr bool equal(std::string_view a, std::string_view b, bool fold)
+    {
+        if (!fold || a.size() != b.size())
+        {
+            return a == b;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (lower(a[i]) != lower(b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Orders two names consistently with equal().
+     * @param a The first name.
+     * @param b The second name.
+     * @param fold True to ignore ASCII case.
+     * @return True if a sorts before b, comparing bytes as unsigned.
+     */
+    static constexpr bool less(std::string_view a, std::string_view b, bool fold)
+    {
+        if (!fold)
+        {
+            return a < b;
+        }
+        const size_t common = (a.size() < b.size()) ? a.size() : b.size();
+        for (size_t i = 0; i < common; ++i)
+        {
+            const unsigned char x = static_cast<unsigned char>(lower(a[i]));
+            const unsigned char y = static_cast<unsigned char>(lower(b[i]));
+            if (x != y)
+            {
+                return x < y;
+            }
+        }
+        return a.size() < b.size();
+    }
+
+    /**
+     * @brief Lowers an ASCII letter; other bytes are returned unchanged.
+     */
+    static constexpr char lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+private:
+    static constexpr uint64_t offset_basis = 14695981039346656037ull; ///< FNV-1a start value.
+    static constexpr uint64_t prime = 1099511628211ull;               ///< FNV-1a multiplier.
+
+    /**
+     * @brief Folds bytes into a running FNV-1a hash.
+     */
+    static constexpr uint64_t append(uint64_t h, std::string_view bytes, bool fold)
+    {
+        for (size_t i = 0; i < bytes.size(); ++i)
+        {
+            const char c = fold ? lower(bytes[i]) : bytes[i];
+            h = (h ^ static_cast<uint8_t>(c)) * prime;
+        }
+        return h;
+    }
+};
+
+#endif // INI_HASH_HPP
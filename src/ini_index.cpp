@@ -0,0 +1,238 @@
+/**
+ * @file ini_index.cpp
+ * @brief Implementation of the sorted name index for INI queries.
+ * @details Sorting, prefix ranges and glob matching for IniIndex.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ini_index.hpp"
+#include "ini_hash.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Indexes the sections and entries of a table.
+ * @details Both lists are sorted stably, so equal names keep table order.
+ * @param table The table; buffers from a previous build are reused.
+ */
+void IniIndex::build(const IniTable &table)
+{
+    const bool fold = table.folds_case();
+
+    _sections.resize(table.section_count());
+    std::iota(_sections.begin(), _sections.end(), 0);
+    std::stable_sort(_sections.begin(), _sections.end(), [&table, fold](uint32_t a, uint32_t b)
+                     { return IniHash::less(table.section_name(a), table.section_name(b), fold); });
+
+    _section_sizes.assign(table.section_count(), 0);
+    for (size_t s = 0; s < table.section_count(); ++s)
+    {
+        for (size_t i = table.section_first(s); i != IniTable::npos; i = table.next_in_section(i))
+        {
+            ++_section_sizes[s];
+        }
+    }
+
+    _keys.resize(table.size());
+    std::iota(_keys.begin(), _keys.end(), 0);
+    std::stable_sort(_keys.begin(), _keys.end(), [&table, fold](uint32_t a, uint32_t b)
+                     { return IniHash::less(table.key(a), table.key(b), fold); });
+}
+
+/**
+ * @brief Checks whether the index has the table's entry and section counts.
+ */
+bool IniIndex::covers(const IniTable &table) const
+{
+    return _keys.size() == table.size() && _sections.size() == table.section_count();
+}
+
+/**
+ * @brief Finds sections whose names match a pattern.
+ * @param table The indexed table.
+ * @param pattern Glob over section names.
+ * @param sections Receives matching section indices in table order.
+ */
+void IniIndex::match_sections(const IniTable &table, std::string_view pattern, std::vector<size_t> &sections) const
+{
+    const bool fold = table.folds_case();
+    const auto range = prefix_range(_sections, literal_prefix(pattern), fold,
+                                    [&table](uint32_t s) { return table.section_name(s); });
+
+    sections.clear();
+    for (size_t i = range.first; i < range.second; ++i)
+    {
+        if (glob(pattern, table.section_name(_sections[i]), fold))
+        {
+            sections.push_back(_sections[i]);
+        }
+    }
+    std::sort(sections.begin(), sections.end());
+}
+
+/**
+ * @brief Finds entries whose section and key match patterns.
+ * @details Counts the candidates on each side, capped at the size of the
+ *          smaller so far, then walks whichever is narrower: the keys
+ *          sharing the key prefix, or the entries of sections sharing the
+ *          section prefix.
+ * @param table The indexed table.
+ * @param section_pattern Glob over section names.
+ * @param key_pattern Glob over key names.
+ * @param entries Receives matching entry indices in table order.
+ */
+void IniIndex::match(const IniTable &table, std::string_view section_pattern, std::string_view key_pattern,
+                     std::vector<size_t> &entries) const
+{
+    const bool fold = table.folds_case();
+    const auto sections = prefix_range(_sections, literal_prefix(section_pattern), fold,
+                                       [&table](uint32_t s) { return table.section_name(s); });
+    const auto keys = prefix_range(_keys, literal_prefix(key_pattern), fold,
+                                   [&table](uint32_t i) { return table.key(i); });
+
+    const size_t by_key = keys.second - keys.first;
+    size_t by_section = 0;
+    for (size_t i = sections.first; i < sections.second && by_section <= by_key; ++i)
+    {
+        by_section += _section_sizes[_sections[i]];
+    }
+
+    entries.clear();
+    if (by_key < by_section)
+    {
+        for (size_t i = keys.first; i < keys.second; ++i)
+        {
+            const size_t entry = _keys[i];
+            if (glob(key_pattern, table.key(entry), fold) && glob(section_pattern, table.section(entry), fold))
+            {
+                entries.push_back(entry);
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = sections.first; i < sections.second; ++i)
+        {
+            const size_t section = _sections[i];
+            if (!glob(section_pattern, table.section_name(section), fold))
+            {
+                continue;
+            }
+            for (size_t entry = table.section_first(section); entry != IniTable::npos;
+                 entry = table.next_in_section(entry))
+            {
+                if (glob(key_pattern, table.key(entry), fold))
+                {
+                    entries.push_back(entry);
+                }
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+}
+
+/**
+ * @brief Matches a name against a glob.
+ * @details Backtracks only to the most recent `*`, which is enough for
+ *          globs and keeps matching linear in practice.
+ * @param pattern The glob; `*` matches any run and `?` any one character.
+ * @param text The name.
+ * @param fold True to ignore ASCII case.
+ * @return True if the whole name matches.
+ */
+bool IniIndex::glob(std::string_view pattern, std::string_view text, bool fold)
+{
+    size_t p = 0;
+    size_t t = 0;
+    size_t star = std::string_view::npos;
+    size_t resume = 0;
+    while (t < text.size())
+    {
+        if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = p++;
+            resume = t;
+        }
+        else if (p < pattern.size() &&
+                 (pattern[p] == '?' || (fold ? IniHash::lower(pattern[p]) == IniHash::lower(text[t]) : pattern[p] == text[t])))
+        {
+            ++p;
+            ++t;
+        }
+        else if (star != std::string_view::npos)
+        {
+            p = star + 1;
+            t = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+/**
+ * @brief Adds the index's heap blocks to a tally.
+ */
+void IniIndex::memory_usage(IniMemoryUsage &usage) const
+{
+    usage.add(_sections);
+    usage.add(_section_sizes);
+    usage.add(_keys);
+}
+
+/**
+ * @brief Returns the part of a pattern before its first wildcard.
+ */
+std::string_view IniIndex::literal_prefix(std::string_view pattern)
+{
+    return pattern.substr(0, pattern.find_first_of("*?"));
+}
+
+/**
+ * @brief Returns the positions in a sorted list of names starting with a prefix.
+ * @details Names starting with the prefix sort together, right at the first
+ *          name not less than the prefix.
+ */
+template <typename Name>
+std::pair<size_t, size_t> IniIndex::prefix_range(const std::vector<uint32_t> &sorted, std::string_view prefix,
+                                                  bool fold, Name name)
+{
+    auto first = std::partition_point(sorted.begin(), sorted.end(), [&](uint32_t i)
+                                      { return IniHash::less(name(i), prefix, fold); });
+    auto last = std::partition_point(first, sorted.end(), [&](uint32_t i)
+                                     {
+                                         const std::string_view text = name(i);
+                                         return text.size() >= prefix.size() &&
+                                                IniHash::equal(text.substr(0, prefix.size()), prefix, fold);
+                                     });
+    return {static_cast<size_t>(first - sorted.begin()), static_cast<size_t>(last - sorted.begin())};
+}
@@ -0,0 +1,132 @@
+/**
+ * @file ini_index.hpp
+ * @brief Sorted name index for prefix and glob queries over INI data.
+ * @details Orders the sections and keys of an IniTable by name so that
+ *          queries only look at names sharing the pattern's literal prefix.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_INDEX_HPP
+#define INI_INDEX_HPP
+
+#include "ini_memory.hpp"
+#include "ini_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class IniIndex
+ * @brief Section and key names of an IniTable in sorted order.
+ * @details Holds section indices sorted by name and entry indices sorted by
+ *          key, compared the way the table compares names. A query splits
+ *          each glob at its first wildcard, binary-searches both sorted lists
+ *          for names starting with that literal prefix, and checks only the
+ *          narrower set of candidates against the full patterns, so it runs
+ *          in O(log n + candidates) rather than scanning every entry.
+ *
+ *          Patterns use `*` for any run of characters and `?` for any one
+ *          character; everything else matches itself, ignoring ASCII case if
+ *          the table folds case.
+ *
+ *          The index stores indices only, so it must be rebuilt whenever
+ *          entries or sections are added, removed or reordered.
+ */
+class IniIndex
+{
+public:
+    /**
+     * @brief Indexes the sections and entries of a table.
+     * @param table The table; buffers from a previous build are reused.
+     */
+    void build(const IniTable &table);
+
+    /**
+     * @brief Checks whether the index has the table's entry and section counts.
+     * @details Catches entries added since build(); callers must still
+     *          rebuild after anything that erases or reorders.
+     */
+    bool covers(const IniTable &table) const;
+
+    /**
+     * @brief Finds sections whose names match a pattern.
+     * @param table The indexed table.
+     * @param pattern Glob over section names.
+     * @param sections Receives matching section indices in table order.
+     */
+    void match_sections(const IniTable &table, std::string_view pattern, std::vector<size_t> &sections) const;
+
+    /**
+     * @brief Finds entries whose section and key match patterns.
+     * @param table The indexed table.
+     * @param section_pattern Glob over section names.
+     * @param key_pattern Glob over key names.
+     * @param entries Receives matching entry indices in table order.
+     */
+    void match(const IniTable &table, std::string_view section_pattern, std::string_view key_pattern,
+               std::vector<size_t> &entries) const;
+
+    /**
+     * @brief Matches a name against a glob.
+     * @param pattern The glob; `*` matches any run and `?` any one character.
+     * @param text The name.
+     * @param fold True to ignore ASCII case.
+     * @return True if the whole name matches.
+     */
+    static bool glob(std::string_view pattern, std::string_view text, bool fold);
+
+    /**
+     * @brief Adds the index's heap blocks to a tally.
+     * @param usage The tally to add to.
+     */
+    void memory_usage(IniMemoryUsage &usage) const;
+
+private:
+    /**
+     * @brief Returns the part of a pattern before its first wildcard.
+     */
+    static std::string_view literal_prefix(std::string_view pattern);
+
+    /**
+     * @brief Returns the positions in a sorted list of names starting with a prefix.
+     * @param sorted Indices sorted by the names that name() returns.
+     * @param prefix The literal prefix.
+     * @param fold True to ignore ASCII case.
+     * @param name Returns the name for an index.
+     * @return Half-open range of positions in sorted.
+     */
+    template <typename Name>
+    static std::pair<size_t, size_t> prefix_range(const std::vector<uint32_t> &sorted, std::string_view prefix,
+                                                  bool fold, Name name);
+
+    std::vector<uint32_t> _sections;      ///< Section indices sorted by name.
+    std::vector<uint32_t> _section_sizes; ///< Entry count per section index.
+    std::vector<uint32_t> _keys;          ///< Entry indices sorted by key.
+};
+
+#endif // INI_INDEX_HPP
@@ -0,0 +1,99 @@
+/**
+ * @file ini_key.hpp
+ * @brief Typed key descriptors hashed at compile time.
+ * @details An IniKey names a section and key, carries the value type in
+ *          its own type, and stores the hash of its names so that lookups
+ *          through IniFile::get() do no hashing at run time.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_KEY_HPP
+#define INI_KEY_HPP
+
+#include "ini_hash.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @class IniKey
+ * @brief A section/key pair and the type its value is read as.
+ * @details Meant to be declared constexpr, usually at namespace scope:
+ * @code
+ * constexpr IniKey<int> TxPower{"Common", "TX Power"};
+ * int power = iniFile.get(TxPower);
+ * @endcode
+ *          Both the plain and the case-folded hash are computed up front,
+ *          so the key works whichever mode the IniFile is in.
+ * @tparam T bool, int, double or std::string.
+ */
+template <typename T>
+class IniKey
+{
+    static_assert(std::is_same<T, bool>::value || std::is_same<T, int>::value ||
+                      std::is_same<T, double>::value || std::is_same<T, std::string>::value,
+                  "IniKey values must be bool, int, double or std::string.");
+
+public:
+    using value_type = T; ///< The type get() returns.
+
+    /**
+     * @brief Names a key and hashes it.
+     * @param section The section name; must outlive the key.
+     * @param key The key name; must outlive the key.
+     */
+    constexpr IniKey(std::string_view section, std::string_view key)
+        : _section(section), _key(key), _hash(IniHash::key(section, key)),
+          _folded_hash(IniHash::key(section, key, true))
+    {
+    }
+
+    /**
+     * @brief Section name.
+     */
+    constexpr std::string_view section() const { return _section; }
+
+    /**
+     * @brief Key name.
+     */
+    constexpr std::string_view key() const { return _key; }
+
+    /**
+     * @brief Returns the precomputed hash of the names.
+     * @param fold True for the case-folded hash.
+     * @return IniHash::key() of section and key with that fold flag.
+     */
+    constexpr uint64_t hash(bool fold) const { return fold ? _folded_hash : _hash; }
+
+private:
+    std::string_view _section; ///< Section name.
+    std::string_view _key;     ///< Key name.
+    uint64_t _hash;            ///< IniHash::key() of section and key.
+    uint64_t _folded_hash;     ///< The same hash with case folded.
+};
+
+#endif // INI_KEY_HPP
@@ -0,0 +1,133 @@
+/**
+ * @file ini_memory.cpp
+ * @brief Implementation of the heap tallies behind IniFile::memory_stats().
+ * @details Usable-size queries and node rounding.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ini_memory.hpp"
+
+#include <functional>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Bytes of bookkeeping the allocator keeps in front of each block.
+     */
+    constexpr size_t chunk_header = sizeof(size_t);
+
+    /**
+     * @brief Smallest block the allocator hands out, header included.
+     */
+    constexpr size_t min_chunk = 4 * sizeof(size_t);
+
+    /**
+     * @brief Alignment of block sizes, header included.
+     */
+    constexpr size_t chunk_align = 2 * sizeof(size_t);
+}
+
+/**
+ * @brief Counts one heap block.
+ */
+void IniMemoryUsage::add(const void *block, size_t requested)
+{
+    if (block == nullptr || requested == 0)
+    {
+        return;
+    }
+    bytes += requested;
+    overhead += chunk_header;
+    ++allocations;
+#ifdef __GLIBC__
+    overhead += malloc_usable_size(const_cast<void *>(block)) - requested;
+#endif
+}
+
+/**
+ * @brief Counts a node of a node-based container.
+ */
+void IniMemoryUsage::add_node(size_t requested)
+{
+    size_t chunk = (requested + chunk_header + chunk_align - 1) & ~(chunk_align - 1);
+    if (chunk < min_chunk)
+    {
+        chunk = min_chunk;
+    }
+    bytes += requested;
+    overhead += chunk - requested;
+    ++allocations;
+}
+
+/**
+ * @brief Counts the buffer of a string, if it has left the inline buffer.
+ * @details A string whose data lies inside the object itself uses the
+ *          small-string buffer and owns no heap block.
+ */
+void IniMemoryUsage::add(const std::string &text)
+{
+    const std::less<const char *> before;
+    const char *object = reinterpret_cast<const char *>(&text);
+    if (!before(text.data(), object) && before(text.data(), object + sizeof(text)))
+    {
+        return;
+    }
+    add(text.data(), text.capacity() + 1);
+}
+
+/**
+ * @brief Adds bytes, overhead and allocations of another tally.
+ */
+IniMemoryUsage &IniMemoryUsage::operator+=(const IniMemoryUsage &other)
+{
+    bytes += other.bytes;
+    overhead += other.overhead;
+    allocations += other.allocations;
+    return *this;
+}
+
+/**
+ * @brief Bytes requested plus overhead.
+ */
+size_t IniMemoryUsage::total() const
+{
+    return bytes + overhead;
+}
+
+/**
+ * @brief Sum of all heap groups.
+ */
+IniMemoryUsage IniMemoryStats::total() const
+{
+    IniMemoryUsage sum = lines;
+    sum += data;
+    sum += index;
+    sum += other;
+    return sum;
+}
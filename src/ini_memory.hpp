@@ -0,0 +1,124 @@
+/**
+ * @file ini_memory.hpp
+ * @brief Heap accounting for the structures behind an IniFile.
+ * @details IniMemoryUsage tallies live heap blocks by asking the allocator
+ *          how large each one really is, so reported figures include the
+ *          allocator's rounding and chunk headers rather than estimates.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_MEMORY_HPP
+#define INI_MEMORY_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct IniMemoryUsage
+ * @brief Heap held by one group of containers.
+ */
+struct IniMemoryUsage
+{
+    size_t bytes = 0;       ///< Bytes requested from the allocator.
+    size_t overhead = 0;    ///< Bytes the allocator spends beyond the requests: rounding and chunk headers.
+    size_t allocations = 0; ///< Live heap blocks.
+
+    /**
+     * @brief Counts one heap block.
+     * @details The allocator is asked for the block's usable size where the
+     *          C library supports it (glibc); elsewhere only the chunk
+     *          header is counted as overhead.
+     * @param block Start of the block, or nullptr for none.
+     * @param requested Bytes the container asked for.
+     */
+    void add(const void *block, size_t requested);
+
+    /**
+     * @brief Counts a node of a node-based container.
+     * @details Node addresses are not exposed by the standard containers,
+     *          so the allocator's rounding is applied to the request.
+     * @param requested Bytes of one node.
+     */
+    void add_node(size_t requested);
+
+    /**
+     * @brief Counts the buffer of a string, if it has left the inline buffer.
+     */
+    void add(const std::string &text);
+
+    /**
+     * @brief Counts the buffer of a vector.
+     */
+    template <typename T>
+    void add(const std::vector<T> &items)
+    {
+        add(items.data(), items.capacity() * sizeof(T));
+    }
+
+    /**
+     * @brief Adds bytes, overhead and allocations of another tally.
+     */
+    IniMemoryUsage &operator+=(const IniMemoryUsage &other);
+
+    /**
+     * @brief Bytes requested plus overhead.
+     */
+    size_t total() const;
+};
+
+/**
+ * @struct IniSectionMemory
+ * @brief Memory attributable to one section of the key table.
+ */
+struct IniSectionMemory
+{
+    std::string_view name;   ///< Section name; valid until the next change or load.
+    size_t entries = 0;      ///< Number of keys.
+    size_t bytes = 0;        ///< Heap bytes: entry records, their share of the slot array, the name and copied text.
+    size_t source_bytes = 0; ///< Key and value bytes read in place from the file.
+};
+
+/**
+ * @struct IniMemoryStats
+ * @brief Memory held by an IniFile, as returned by IniFile::memory_stats().
+ */
+struct IniMemoryStats
+{
+    IniMemoryUsage lines;                   ///< Line index and section blocks.
+    IniMemoryUsage data;                    ///< Key table, including the buffers kept for the next load.
+    IniMemoryUsage index;                   ///< Sorted name index used by queries.
+    IniMemoryUsage other;                   ///< Lazy-load offsets, the getData() copy, owned file text and the filename.
+    size_t mapped = 0;                      ///< File and snapshot bytes mapped from disk rather than allocated.
+    std::vector<IniSectionMemory> sections; ///< Per-section figures, in table order.
+
+    /**
+     * @brief Sum of all heap groups.
+     */
+    IniMemoryUsage total() const;
+};
+
+#endif // INI_MEMORY_HPP
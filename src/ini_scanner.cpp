@@ -0,0 +1,396 @@
+/**
+ * @file ini_scanner.cpp
+ * @brief Implementation of the vectorized INI line and delimiter scanner.
+ * @details Provides AVX2, SSE2 and scalar block classifiers, selected once at
+ *          runtime unless use_implementation() names one, and the mask walk
+ *          that splits text into lines.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ini_scanner.hpp"
+
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INI_SCANNER_X86 1
+#endif
+
+namespace
+{
+    /**
+     * @brief Signature shared by the block classifiers.
+     */
+    using ClassifyFn = void (*)(const char *, IniScanner::Masks &);
+
+    /**
+     * @brief Classifies a full block one byte at a time.
+     * @param data Start of a 64-byte block.
+     * @param masks Receives the character classes.
+     */
+    void classify_scalar(const char *data, IniScanner::Masks &masks)
+    {
+        masks = IniScanner::Masks{};
+        for (size_t i = 0; i < IniScanner::block_size; ++i)
+        {
+            const uint64_t bit = uint64_t(1) << i;
+            switch (data[i])
+            {
+            case '\n':
+                masks.newline |= bit;
+                break;
+            case '=':
+                masks.equals |= bit;
+                break;
+            case '[':
+                masks.open |= bit;
+                break;
+            case ']':
+                masks.close |= bit;
+                break;
+            case ';':
+            case '#':
+                masks.comment |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\r':
+                masks.space |= bit;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+#if defined(INI_SCANNER_X86) && defined(__SSE2__)
+    /**
+     * @brief Returns a 16-bit mask of the bytes in v equal to c.
+     */
+    inline uint64_t match_sse2(__m128i v, char c)
+    {
+        return static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+    }
+
+    /**
+     * @brief Classifies a full block as four 16-byte vectors.
+     * @param data Start of a 64-byte block.
+     * @param masks Receives the character classes.
+     */
+    void classify_sse2(const char *data, IniScanner::Masks &masks)
+    {
+        masks = IniScanner::Masks{};
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            const unsigned shift = static_cast<unsigned>(16 * i);
+            masks.newline |= match_sse2(v, '\n') << shift;
+            masks.equals |= match_sse2(v, '=') << shift;
+            masks.open |= match_sse2(v, '[') << shift;
+            masks.close |= match_sse2(v, ']') << shift;
+            masks.comment |= (match_sse2(v, ';') | match_sse2(v, '#')) << shift;
+            masks.space |= (match_sse2(v, ' ') | match_sse2(v, '\t') | match_sse2(v, '\r')) << shift;
+        }
+    }
+#endif
+
+#if defined(INI_SCANNER_X86)
+    /**
+     * @brief Returns a 32-bit mask of the bytes in v equal to c.
+     */
+    __attribute__((target("avx2"))) inline uint64_t match_avx2(__m256i v, char c)
+    {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+    }
+
+    /**
+     * @brief Classifies a full block as two 32-byte vectors.
+     * @param data Start of a 64-byte block.
+     * @param masks Receives the character classes.
+     */
+    __attribute__((target("avx2"))) void classify_avx2(const char *data, IniScanner::Masks &masks)
+    {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32));
+
+        masks.newline = match_avx2(lo, '\n') | match_avx2(hi, '\n') << 32;
+        masks.equals = match_avx2(lo, '=') | match_avx2(hi, '=') << 32;
+        masks.open = match_avx2(lo, '[') | match_avx2(hi, '[') << 32;
+        masks.close = match_avx2(lo, ']') | match_avx2(hi, ']') << 32;
+        masks.comment = (match_avx2(lo, ';') | match_avx2(lo, '#')) |
+                        (match_avx2(hi, ';') | match_avx2(hi, '#')) << 32;
+        masks.space = (match_avx2(lo, ' ') | match_avx2(lo, '\t') | match_avx2(lo, '\r')) |
+                      (match_avx2(hi, ' ') | match_avx2(hi, '\t') | match_avx2(hi, '\r')) << 32;
+    }
+#endif
+
+    /**
+     * @brief Finds a classifier by name, if this CPU and build provide it.
+     * @param name "avx2", "sse2" or "scalar".
+     * @param found Receives the name as a string literal.
+     * @return The classifier, or nullptr.
+     */
+    ClassifyFn find_classifier(std::string_view name, const char *&found)
+    {
+#if defined(INI_SCANNER_X86)
+        __builtin_cpu_init();
+        if (name == "avx2" && __builtin_cpu_supports("avx2"))
+        {
+            found = "avx2";
+            return classify_avx2;
+        }
+#endif
+#if defined(INI_SCANNER_X86) && defined(__SSE2__)
+        if (name == "sse2")
+        {
+            found = "sse2";
+            return classify_sse2;
+        }
+#endif
+        if (name == "scalar")
+        {
+            found = "scalar";
+            return classify_scalar;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Picks the fastest classifier supported by this CPU.
+     * @param name Receives the name of the selected classifier.
+     * @return The selected classifier.
+     */
+    ClassifyFn select_classifier(const char *&name)
+    {
+        for (const char *candidate : {"avx2", "sse2"})
+        {
+            if (ClassifyFn fn = find_classifier(candidate, name))
+            {
+                return fn;
+            }
+        }
+        return find_classifier("scalar", name);
+    }
+
+    /**
+     * @brief Name and function of the classifier in use.
+     */
+    struct Classifier
+    {
+        const char *name = nullptr;
+        ClassifyFn fn = select_classifier(name);
+    };
+
+    /**
+     * @brief Returns the classifier in use, chosen for this CPU at first use.
+     */
+    Classifier &classifier()
+    {
+        static Classifier selected;
+        return selected;
+    }
+
+    /**
+     * @brief Returns a mask with the low n bits set.
+     */
+    inline uint64_t low_bits(size_t n)
+    {
+        return (n >= 64) ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+    }
+}
+
+/**
+ * @brief Constructs a scanner over text.
+ * @param text The text to scan. Must outlive the scanner.
+ */
+IniScanner::IniScanner(std::string_view text) : _text(text)
+{
+}
+
+/**
+ * @brief Classifies one block of text.
+ * @details Short blocks are copied into a zero-filled buffer first so the
+ *          vector classifiers never read past the end of the text.
+ * @param data Start of the block.
+ * @param length Bytes available, at most block_size.
+ * @param masks Receives the character classes.
+ */
+void IniScanner::classify(const char *data, size_t length, Masks &masks)
+{
+    if (length >= block_size)
+    {
+        classifier().fn(data, masks);
+        return;
+    }
+
+    char padded[block_size] = {};
+    std::memcpy(padded, data, length);
+    classifier().fn(padded, masks);
+}
+
+/**
+ * @brief Names the classifier selected for this CPU.
+ * @return "avx2", "sse2" or "scalar".
+ */
+const char *IniScanner::implementation()
+{
+    return classifier().name;
+}
+
+/**
+ * @brief Switches every scanner to a named classifier.
+ * @param name "avx2", "sse2" or "scalar", or empty for the default.
+ * @return False, changing nothing, if this CPU or build lacks it.
+ */
+bool IniScanner::use_implementation(std::string_view name)
+{
+    Classifier &current = classifier();
+    const char *found = nullptr;
+    ClassifyFn fn = name.empty() ? select_classifier(found) : find_classifier(name, found);
+    if (fn == nullptr)
+    {
+        return false;
+    }
+    current.fn = fn;
+    current.name = found;
+    return true;
+}
+
+/**
+ * @brief Counts the lines next() would return for text.
+ * @param text The text to count.
+ * @return Number of lines.
+ */
+size_t IniScanner::count_lines(std::string_view text)
+{
+    size_t count = 0;
+    Masks masks;
+    for (size_t base = 0; base < text.size(); base += block_size)
+    {
+        classify(text.data() + base, text.size() - base, masks);
+        count += static_cast<size_t>(__builtin_popcountll(masks.newline));
+    }
+
+    // A final line without a newline still counts
+    if (!text.empty() && text.back() != '\n')
+    {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief Classifies the block with the given index into _masks.
+ * @param index Block number, counted from the start of the text.
+ */
+void IniScanner::load_block(size_t index)
+{
+    const size_t base = index * block_size;
+    classify(_text.data() + base, _text.size() - base, _masks);
+    _block = index;
+}
+
+/**
+ * @brief Advances to the next line.
+ * @details Walks the block masks from the start of the line to its newline,
+ *          collecting the first and last non-whitespace bytes, the first '='
+ *          and the first comment character after it along the way.
+ * @param line Receives the delimiter positions of the line.
+ * @return False once the text is exhausted.
+ */
+bool IniScanner::next(Line &line)
+{
+    if (_pos >= _text.size())
+    {
+        return false;
+    }
+
+    line = Line{_pos, npos, npos, npos, npos, npos};
+    size_t pos = _pos;
+
+    for (;;)
+    {
+        const size_t index = pos / block_size;
+        const size_t base = index * block_size;
+        if (index != _block)
+        {
+            load_block(index);
+        }
+
+        // Bits from pos up to the end of the text or the block
+        uint64_t range = ~low_bits(pos - base) & low_bits(_text.size() - base);
+        const uint64_t newline = _masks.newline & range;
+        if (newline != 0)
+        {
+            range &= (newline & (~newline + 1)) - 1;
+        }
+
+        const uint64_t solid = range & ~_masks.space;
+        if (solid != 0)
+        {
+            if (line.first == npos)
+            {
+                line.first = base + static_cast<size_t>(__builtin_ctzll(solid));
+            }
+            line.last = base + 63 - static_cast<size_t>(__builtin_clzll(solid));
+        }
+
+        uint64_t comment = _masks.comment & range;
+        if (line.equals == npos)
+        {
+            const uint64_t equals = _masks.equals & range;
+            if (equals != 0)
+            {
+                const size_t bit = static_cast<size_t>(__builtin_ctzll(equals));
+                line.equals = base + bit;
+                comment &= ~low_bits(bit + 1);
+            }
+            else
+            {
+                comment = 0;
+            }
+        }
+        if (line.comment == npos && comment != 0)
+        {
+            line.comment = base + static_cast<size_t>(__builtin_ctzll(comment));
+        }
+
+        if (newline != 0)
+        {
+            line.end = base + static_cast<size_t>(__builtin_ctzll(newline));
+            _pos = line.end + 1;
+            return true;
+        }
+
+        pos = base + block_size;
+        if (pos >= _text.size())
+        {
+            line.end = _text.size();
+            _pos = line.end;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * @file ini_scanner.hpp
+ * @brief Vectorized line and delimiter scanner for INI text.
+ * @details Classifies INI text in 64-byte blocks into bit masks of newline,
+ *          '=', '[', ']', comment and whitespace positions, and walks those
+ *          masks to split the text into lines and locate their delimiters.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_SCANNER_HPP
+#define INI_SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @class IniScanner
+ * @brief Splits INI text into lines and locates their delimiters.
+ * @details Each 64-byte block of text is classified once into bit masks, with
+ *          bit i describing byte i of the block. The classifier uses AVX2 or
+ *          SSE2 when the CPU supports them and a scalar loop otherwise; the
+ *          choice is made once at runtime. Lines are then found by walking
+ *          the masks instead of the bytes.
+ */
+class IniScanner
+{
+public:
+    /**
+     * @brief Character classes for one 64-byte block.
+     */
+    struct Masks
+    {
+        uint64_t newline; ///< '\n'
+        uint64_t equals;  ///< '='
+        uint64_t open;    ///< '['
+        uint64_t close;   ///< ']'
+        uint64_t comment; ///< ';' or '#'
+        uint64_t space;   ///< ' ', '\t' or '\r'
+    };
+
+    /**
+     * @brief Delimiter positions of one line, as offsets into the text.
+     */
+    struct Line
+    {
+        size_t begin;   ///< First byte of the line.
+        size_t end;     ///< One past the last byte, excluding the newline.
+        size_t first;   ///< First non-whitespace byte, or npos if blank.
+        size_t last;    ///< Last non-whitespace byte, or npos if blank.
+        size_t equals;  ///< First '=', or npos.
+        size_t comment; ///< First ';' or '#' after equals, or npos.
+    };
+
+    /**
+     * @brief Marker for a delimiter that is not present.
+     */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Size of a classified block in bytes.
+     */
+    static constexpr size_t block_size = 64;
+
+    /**
+     * @brief Constructs a scanner over text.
+     * @param text The text to scan. Must outlive the scanner.
+     */
+    explicit IniScanner(std::string_view text);
+
+    /**
+     * @brief Advances to the next line.
+     * @details Follows std::getline() rules: a trailing newline does not
+     *          start an extra empty line.
+     * @param line Receives the delimiter positions of the line.
+     * @return False once the text is exhausted.
+     */
+    bool next(Line &line);
+
+    /**
+     * @brief Counts the lines next() would return for text.
+     * @param text The text to count.
+     * @return Number of lines.
+     */
+    static size_t count_lines(std::string_view text);
+
+    /**
+     * @brief Classifies one block of text.
+     * @param data Start of the block.
+     * @param length Bytes available, at most block_size. Bits past length are clear.
+     * @param masks Receives the character classes.
+     */
+    static void classify(const char *data, size_t length, Masks &masks);
+
+    /**
+     * @brief Names the classifier selected for this CPU.
+     * @return "avx2", "sse2" or "scalar".
+     */
+    static const char *implementation();
+
+    /**
+     * @brief Switches every scanner to a named classifier.
+     * @details Meant for tests and benchmarks that compare classifiers on
+     *          one machine. It is not synchronised with running scans, so
+     *          call it while no other thread is scanning.
+     * @param name "avx2", "sse2" or "scalar", or empty for the default.
+     * @return False, changing nothing, if this CPU or build lacks it.
+     */
+    static bool use_implementation(std::string_view name);
+
+private:
+    /**
+     * @brief Classifies the block with the given index into _masks.
+     * @param index Block number, counted from the start of the text.
+     */
+    void load_block(size_t index);
+
+    std::string_view _text; ///< Text being scanned.
+    size_t _pos = 0;        ///< Offset of the next line.
+    size_t _block = npos;   ///< Index of the block held in _masks.
+    Masks _masks{};         ///< Classes of the current block.
+};
+
+#endif // INI_SCANNER_HPP
@@ -0,0 +1,466 @@
+/**
+ * @file ini_snapshot.cpp
+ * @brief Implementation of the precompiled binary snapshot (.inib) format.
+ * @details Builds the snapshot tables in memory and serves lookups straight
+ *          from a read-only mapping of a snapshot file.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ini_snapshot.hpp"
+#include "ini_hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Fixed header at offset 0 of a snapshot file.
+ */
+struct IniSnapshot::Header
+{
+    char magic[4];          ///< "INIB".
+    uint32_t version;       ///< IniSnapshot::version.
+    uint32_t byte_order;    ///< byte_order_mark as written by the builder.
+    uint32_t section_count; ///< Records in the section table.
+    uint32_t entry_count;   ///< Records in the entry table.
+    uint32_t bucket_count;  ///< Slots in the bucket array; a power of two.
+    uint64_t file_size;     ///< Total size of the file.
+    uint64_t source_size;   ///< Size of the INI text.
+    uint64_t source_hash;   ///< Hash of the INI text.
+    uint64_t sections;      ///< Offset of the section table.
+    uint64_t entries;       ///< Offset of the entry table.
+    uint64_t buckets;       ///< Offset of the bucket array.
+    uint64_t strings;       ///< Offset of the string table.
+    uint64_t strings_size;  ///< Size of the string table.
+};
+
+/**
+ * @brief One section and the run of entries it owns.
+ */
+struct IniSnapshot::SectionRecord
+{
+    uint64_t name;         ///< Offset of the name in the string table.
+    uint32_t name_length;  ///< Length of the name.
+    uint32_t first_entry;  ///< Index of the section's first entry.
+    uint32_t entry_count;  ///< Number of entries in the section.
+    uint32_t padding;      ///< Always zero.
+};
+
+/**
+ * @brief One key/value pair.
+ */
+struct IniSnapshot::Entry
+{
+    uint64_t hash;         ///< IniHash::key() of section and key.
+    uint64_t key;          ///< Offset of the key in the string table.
+    uint64_t value;        ///< Offset of the value in the string table.
+    uint32_t key_length;   ///< Length of the key.
+    uint32_t value_length; ///< Length of the value.
+    uint32_t section;      ///< Index of the owning section.
+    uint32_t line;         ///< Zero-based line number in the source.
+};
+
+namespace
+{
+    const char snapshot_magic[4] = {'I', 'N', 'I', 'B'};
+    constexpr uint32_t byte_order_mark = 0x01020304;
+
+    /**
+     * @brief Rounds an offset up to the table alignment.
+     */
+    inline uint64_t align8(uint64_t offset)
+    {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    /**
+     * @brief Checks that count records of a given size fit at offset.
+     */
+    inline bool fits(uint64_t offset, uint64_t count, uint64_t size, uint64_t file_size)
+    {
+        return offset % 8 == 0 && offset <= file_size && count <= (file_size - offset) / size;
+    }
+
+    [[noreturn]] void corrupt()
+    {
+        throw std::runtime_error("Corrupt ini snapshot.");
+    }
+}
+
+/**
+ * @brief Unmaps the file on destruction.
+ */
+IniSnapshot::~IniSnapshot()
+{
+    close();
+}
+
+/**
+ * @brief Serializes records into the snapshot layout.
+ * @details Records are sorted by section and key, each section name is
+ *          stored once, and every entry is placed in the bucket array by
+ *          linear probing from its hash. The array is at least twice the
+ *          number of entries, which keeps probe runs short.
+ * @param records Key/value pairs; section/key pairs must be unique.
+ * @param source_hash Hash of the INI text the records came from.
+ * @param source_size Size of that text in bytes.
+ * @return The complete file contents.
+ * @throws std::runtime_error if a table exceeds the 32-bit format limits.
+ */
+std::string IniSnapshot::build(std::vector<Record> records, uint64_t source_hash, uint64_t source_size)
+{
+    constexpr uint64_t limit = std::numeric_limits<uint32_t>::max();
+    if (records.size() >= limit / 2)
+    {
+        throw std::runtime_error("Too many keys for an ini snapshot.");
+    }
+
+    std::sort(records.begin(), records.end(), [](const Record &a, const Record &b)
+              { return std::tie(a.section, a.key) < std::tie(b.section, b.key); });
+
+    std::string strings;
+    std::vector<SectionRecord> sections;
+    std::vector<Entry> entries;
+    entries.reserve(records.size());
+
+    for (const Record &record : records)
+    {
+        if (record.section.size() > limit || record.key.size() > limit ||
+            record.value.size() > limit || record.line > limit)
+        {
+            throw std::runtime_error("Ini data too large for a snapshot.");
+        }
+
+        if (sections.empty() ||
+            std::string_view(strings).substr(sections.back().name, sections.back().name_length) != record.section)
+        {
+            sections.push_back(SectionRecord{strings.size(), static_cast<uint32_t>(record.section.size()),
+                                             static_cast<uint32_t>(entries.size()), 0, 0});
+            strings.append(record.section.data(), record.section.size());
+        }
+        sections.back().entry_count++;
+
+        Entry entry{};
+        entry.hash = IniHash::key(record.section, record.key);
+        entry.key = strings.size();
+        entry.key_length = static_cast<uint32_t>(record.key.size());
+        strings.append(record.key.data(), record.key.size());
+        entry.value = strings.size();
+        entry.value_length = static_cast<uint32_t>(record.value.size());
+        strings.append(record.value.data(), record.value.size());
+        entry.section = static_cast<uint32_t>(sections.size() - 1);
+        entry.line = static_cast<uint32_t>(record.line);
+        entries.push_back(entry);
+    }
+
+    uint32_t bucket_count = 1;
+    while (bucket_count < 2 * entries.size())
+    {
+        bucket_count <<= 1;
+    }
+    std::vector<uint32_t> buckets(bucket_count, 0);
+    const uint64_t mask = bucket_count - 1;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        uint64_t pos = entries[i].hash & mask;
+        while (buckets[pos] != 0)
+        {
+            pos = (pos + 1) & mask;
+        }
+        buckets[pos] = static_cast<uint32_t>(i + 1);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = version;
+    header.byte_order = byte_order_mark;
+    header.section_count = static_cast<uint32_t>(sections.size());
+    header.entry_count = static_cast<uint32_t>(entries.size());
+    header.bucket_count = bucket_count;
+    header.source_size = source_size;
+    header.source_hash = source_hash;
+    header.sections = align8(sizeof(Header));
+    header.entries = align8(header.sections + sections.size() * sizeof(SectionRecord));
+    header.buckets = align8(header.entries + entries.size() * sizeof(Entry));
+    header.strings = align8(header.buckets + buckets.size() * sizeof(uint32_t));
+    header.strings_size = strings.size();
+    header.file_size = header.strings + strings.size();
+
+    std::string out(header.file_size, '\0');
+    std::memcpy(&out[0], &header, sizeof(header));
+    std::memcpy(&out[header.sections], sections.data(), sections.size() * sizeof(SectionRecord));
+    std::memcpy(&out[header.entries], entries.data(), entries.size() * sizeof(Entry));
+    std::memcpy(&out[header.buckets], buckets.data(), buckets.size() * sizeof(uint32_t));
+    std::memcpy(&out[header.strings], strings.data(), strings.size());
+    return out;
+}
+
+/**
+ * @brief Maps a snapshot file and checks its header and table bounds.
+ * @details Only the header is validated up front, so opening takes the same
+ *          time for any file size. Ranges read from the tables are checked
+ *          as they are used.
+ * @param path Path to the .inib file.
+ * @return False if the file is missing or not a valid snapshot of this version.
+ */
+bool IniSnapshot::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || static_cast<uint64_t>(st.st_size) < sizeof(Header))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const char *base = static_cast<const char *>(map);
+    const Header *header = reinterpret_cast<const Header *>(base);
+    bool valid = std::memcmp(header->magic, snapshot_magic, sizeof(header->magic)) == 0 &&
+                 header->version == version &&
+                 header->byte_order == byte_order_mark &&
+                 header->file_size == size &&
+                 header->bucket_count != 0 &&
+                 (header->bucket_count & (header->bucket_count - 1)) == 0 &&
+                 header->entry_count < header->bucket_count &&
+                 fits(header->sections, header->section_count, sizeof(SectionRecord), size) &&
+                 fits(header->entries, header->entry_count, sizeof(Entry), size) &&
+                 fits(header->buckets, header->bucket_count, sizeof(uint32_t), size) &&
+                 header->strings <= size && header->strings_size <= size - header->strings;
+    if (!valid)
+    {
+        ::munmap(map, size);
+        return false;
+    }
+
+    close();
+    _map = base;
+    _size = size;
+    _header = header;
+    _sections = reinterpret_cast<const SectionRecord *>(base + header->sections);
+    _entries = reinterpret_cast<const Entry *>(base + header->entries);
+    _buckets = reinterpret_cast<const uint32_t *>(base + header->buckets);
+    _strings = base + header->strings;
+    return true;
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+void IniSnapshot::close()
+{
+    if (_map != nullptr)
+    {
+        ::munmap(const_cast<char *>(_map), _size);
+    }
+    _map = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _sections = nullptr;
+    _entries = nullptr;
+    _buckets = nullptr;
+    _strings = nullptr;
+}
+
+/**
+ * @brief Exchanges the mappings of two snapshots.
+ */
+void IniSnapshot::swap(IniSnapshot &other) noexcept
+{
+    std::swap(_map, other._map);
+    std::swap(_size, other._size);
+    std::swap(_header, other._header);
+    std::swap(_sections, other._sections);
+    std::swap(_entries, other._entries);
+    std::swap(_buckets, other._buckets);
+    std::swap(_strings, other._strings);
+}
+
+/**
+ * @brief Returns true while a snapshot is mapped.
+ */
+bool IniSnapshot::is_open() const
+{
+    return _map != nullptr;
+}
+
+/**
+ * @brief Hash of the INI text the snapshot was built from.
+ */
+uint64_t IniSnapshot::source_hash() const
+{
+    return _header->source_hash;
+}
+
+/**
+ * @brief Size of the INI text the snapshot was built from.
+ */
+uint64_t IniSnapshot::source_size() const
+{
+    return _header->source_size;
+}
+
+/**
+ * @brief Length of the mapping, or 0 if none is open.
+ */
+size_t IniSnapshot::mapped_size() const
+{
+    return _size;
+}
+
+/**
+ * @brief Returns a string from the string table.
+ * @throws std::runtime_error if the range lies outside the table.
+ */
+std::string_view IniSnapshot::string_at(uint64_t offset, uint32_t length) const
+{
+    if (offset > _header->strings_size || length > _header->strings_size - offset)
+    {
+        corrupt();
+    }
+    return std::string_view(_strings + offset, length);
+}
+
+/**
+ * @brief Checks whether a section exists.
+ * @details Binary search over the sorted section table.
+ * @param section The section name.
+ * @return True if the snapshot has the section.
+ */
+bool IniSnapshot::has_section(std::string_view section) const
+{
+    size_t low = 0;
+    size_t high = _header->section_count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        std::string_view name = string_at(_sections[mid].name, _sections[mid].name_length);
+        if (name == section)
+        {
+            return true;
+        }
+        if (name < section)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Looks up a value.
+ * @details Probes the bucket array from the hash of section and key; the
+ *          strings are only compared when the stored hash matches.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value Receives a view into the mapping on success.
+ * @return True if the key was found.
+ * @throws std::runtime_error if the entry points outside the file.
+ */
+bool IniSnapshot::find(std::string_view section, std::string_view key, std::string_view &value) const
+{
+    const uint64_t hash = IniHash::key(section, key);
+    const uint64_t mask = _header->bucket_count - 1;
+    uint64_t pos = hash & mask;
+
+    for (uint32_t probes = 0; probes < _header->bucket_count; ++probes)
+    {
+        const uint32_t slot = _buckets[pos];
+        if (slot == 0)
+        {
+            return false;
+        }
+        if (slot > _header->entry_count)
+        {
+            corrupt();
+        }
+
+        const Entry &entry = _entries[slot - 1];
+        if (entry.hash == hash && string_at(entry.key, entry.key_length) == key)
+        {
+            if (entry.section >= _header->section_count)
+            {
+                corrupt();
+            }
+            const SectionRecord &owner = _sections[entry.section];
+            if (string_at(owner.name, owner.name_length) == section)
+            {
+                value = string_at(entry.value, entry.value_length);
+                return true;
+            }
+        }
+        pos = (pos + 1) & mask;
+    }
+    return false;
+}
+
+/**
+ * @brief Reports every entry, section by section.
+ * @param visitor Receives the entries.
+ * @throws std::runtime_error if an entry points outside the file.
+ */
+void IniSnapshot::unpack(const Visitor &visitor) const
+{
+    for (uint32_t s = 0; s < _header->section_count; ++s)
+    {
+        const SectionRecord &section = _sections[s];
+        if (section.first_entry > _header->entry_count ||
+            section.entry_count > _header->entry_count - section.first_entry)
+        {
+            corrupt();
+        }
+
+        std::string_view name = string_at(section.name, section.name_length);
+        for (uint32_t i = 0; i < section.entry_count; ++i)
+        {
+            const Entry &entry = _entries[section.first_entry + i];
+            visitor(name, string_at(entry.key, entry.key_length),
+                    string_at(entry.value, entry.value_length), entry.line);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file ini_snapshot.hpp
+ * @brief Precompiled binary snapshot (.inib) of parsed INI data.
+ * @details A snapshot holds every section, key and value of an INI file in a
+ *          layout that is memory-mapped and queried in place, so a process
+ *          can start without parsing the text again.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_SNAPSHOT_HPP
+#define INI_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class IniSnapshot
+ * @brief Read-only, memory-mapped view of a .inib file.
+ * @details The file starts with a versioned header followed by four tables
+ *          that refer to each other only by offset, so the mapping can sit at
+ *          any address:
+ *          - sections, sorted by name, each owning a run of entries;
+ *          - entries (section, key, value, line, hash), grouped by section
+ *            and sorted by key;
+ *          - an open-addressing bucket array over the entry hashes;
+ *          - a string table holding all names, keys and values.
+ *          Values are stored in native byte order; a marker in the header
+ *          rejects files written on a machine with a different one. The
+ *          header also records the size and hash of the INI text the
+ *          snapshot was built from, so callers can detect stale files.
+ */
+class IniSnapshot
+{
+public:
+    /**
+     * @brief Layout version; files with any other version are rejected.
+     */
+    static constexpr uint32_t version = 1;
+
+    /**
+     * @brief One key/value pair handed to build().
+     */
+    struct Record
+    {
+        std::string_view section; ///< Section name.
+        std::string_view key;     ///< Key name.
+        std::string_view value;   ///< Value text.
+        size_t line;              ///< Zero-based line number in the source.
+    };
+
+    /**
+     * @brief Receives each entry from unpack().
+     */
+    using Visitor = std::function<void(std::string_view section, std::string_view key,
+                                       std::string_view value, size_t line)>;
+
+    IniSnapshot() = default;
+    ~IniSnapshot();
+    IniSnapshot(const IniSnapshot &) = delete;
+    IniSnapshot &operator=(const IniSnapshot &) = delete;
+
+    /**
+     * @brief Serializes records into the snapshot layout.
+     * @param records Key/value pairs; section/key pairs must be unique.
+     * @param source_hash Hash of the INI text the records came from.
+     * @param source_size Size of that text in bytes.
+     * @return The complete file contents.
+     * @throws std::runtime_error if a table exceeds the 32-bit format limits.
+     */
+    static std::string build(std::vector<Record> records, uint64_t source_hash, uint64_t source_size);
+
+    /**
+     * @brief Maps a snapshot file and checks its header and table bounds.
+     * @param path Path to the .inib file.
+     * @return False if the file is missing or not a valid snapshot of this version.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void close();
+
+    /**
+     * @brief Exchanges the mappings of two snapshots.
+     */
+    void swap(IniSnapshot &other) noexcept;
+
+    /**
+     * @brief Returns true while a snapshot is mapped.
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Hash of the INI text the snapshot was built from.
+     */
+    uint64_t source_hash() const;
+
+    /**
+     * @brief Size of the INI text the snapshot was built from.
+     */
+    uint64_t source_size() const;
+
+    /**
+     * @brief Length of the mapping, or 0 if none is open.
+     */
+    size_t mapped_size() const;
+
+    /**
+     * @brief Checks whether a section exists.
+     * @param section The section name.
+     * @return True if the snapshot has the section.
+     */
+    bool has_section(std::string_view section) const;
+
+    /**
+     * @brief Looks up a value.
+     * @param section The section name.
+     * @param key The key name.
+     * @param value Receives a view into the mapping on success.
+     * @return True if the key was found.
+     * @throws std::runtime_error if the entry points outside the file.
+     */
+    bool find(std::string_view section, std::string_view key, std::string_view &value) const;
+
+    /**
+     * @brief Reports every entry, section by section.
+     * @param visitor Receives the entries.
+     * @throws std::runtime_error if an entry points outside the file.
+     */
+    void unpack(const Visitor &visitor) const;
+
+private:
+    struct Header;
+    struct SectionRecord;
+    struct Entry;
+
+    /**
+     * @brief Returns a string from the string table.
+     * @throws std::runtime_error if the range lies outside the table.
+     */
+    std::string_view string_at(uint64_t offset, uint32_t length) const;
+
+    const char *_map = nullptr;              ///< Start of the mapping.
+    size_t _size = 0;                        ///< Length of the mapping.
+    const Header *_header = nullptr;         ///< File header.
+    const SectionRecord *_sections = nullptr; ///< Section table.
+    const Entry *_entries = nullptr;         ///< Entry table.
+    const uint32_t *_buckets = nullptr;      ///< Bucket array.
+    const char *_strings = nullptr;          ///< String table.
+};
+
+#endif // INI_SNAPSHOT_HPP
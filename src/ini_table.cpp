@@ -0,0 +1,847 @@
+/**
+ * @file ini_table.cpp
+ * @brief Implementation of the flat open-addressing INI value store.
+ * @details Slot arrays, linear probing, section chains, source references
+ *          and arena compaction for IniTable.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ini_table.hpp"
+#include "ini_hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    /**
+     * @brief Smallest slot array allocated.
+     */
+    constexpr size_t min_slots = 16;
+
+    /**
+     * @brief Arena garbage tolerated before a compaction is considered.
+     */
+    constexpr size_t min_garbage = 64 * 1024;
+
+    /**
+     * @brief Returns the slot array size that keeps count items at most half full.
+     */
+    size_t slot_count(size_t count)
+    {
+        size_t slots = min_slots;
+        while (slots < 2 * count)
+        {
+            slots <<= 1;
+        }
+        return slots;
+    }
+
+    /**
+     * @brief Places an index in the first free slot from its hash.
+     */
+    void place(std::vector<uint32_t> &slots, uint64_t hash, size_t index)
+    {
+        const size_t mask = slots.size() - 1;
+        size_t pos = static_cast<size_t>(hash) & mask;
+        while (slots[pos] != 0)
+        {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = static_cast<uint32_t>(index + 1);
+    }
+}
+
+/**
+ * @brief Number of entries.
+ */
+size_t IniTable::size() const
+{
+    return _entries.size();
+}
+
+/**
+ * @brief Number of sections, including ones that hold no entries.
+ */
+size_t IniTable::section_count() const
+{
+    return _sections.size();
+}
+
+/**
+ * @brief Removes everything.
+ * @details Buffers keep their capacity and the slot arrays their size, so
+ *          refilling the table to a similar size allocates nothing.
+ */
+void IniTable::clear()
+{
+    _arena.clear();
+    _entries.clear();
+    std::fill(_slots.begin(), _slots.end(), 0);
+    _sections.clear();
+    std::fill(_section_slots.begin(), _section_slots.end(), 0);
+    _garbage = 0;
+    _source = std::string_view();
+    _in_order = true;
+    _last_line = 0;
+}
+
+/**
+ * @brief Sets the text that refer() entries point into.
+ * @param source The text; it must outlive every entry that refers to it.
+ */
+void IniTable::attach(std::string_view source)
+{
+    _source = source;
+}
+
+/**
+ * @brief Makes section and key names match regardless of ASCII case.
+ * @param fold True to ignore case.
+ * @throws std::runtime_error if the table is not empty.
+ */
+void IniTable::fold_case(bool fold)
+{
+    if (fold != _fold && (!_entries.empty() || !_sections.empty()))
+    {
+        throw std::runtime_error("Cannot change case folding of a non-empty ini table.");
+    }
+    _fold = fold;
+}
+
+/**
+ * @brief Checks whether names are matched regardless of ASCII case.
+ */
+bool IniTable::folds_case() const
+{
+    return _fold;
+}
+
+/**
+ * @brief Hashes a section and key the way this table does.
+ */
+uint64_t IniTable::hash(std::string_view section, std::string_view key) const
+{
+    return IniHash::key(section, key, _fold);
+}
+
+/**
+ * @brief Pre-sizes the table.
+ * @param entries Expected number of entries.
+ * @param bytes Expected arena size in bytes.
+ */
+void IniTable::reserve(size_t entries, size_t bytes)
+{
+    _entries.reserve(entries);
+    _arena.reserve(bytes);
+    if (slot_count(entries) > _slots.size())
+    {
+        rehash(entries, _sections.size());
+    }
+}
+
+/**
+ * @brief Finds an entry.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The entry index, or npos.
+ */
+size_t IniTable::find(std::string_view section, std::string_view key) const
+{
+    return find(hash(section, key), section, key);
+}
+
+/**
+ * @brief Finds an entry by its precomputed hash.
+ * @details The slot array is never more than half full, so a probe always
+ *          reaches an empty slot.
+ */
+size_t IniTable::find(uint64_t hash, std::string_view section, std::string_view key) const
+{
+    if (_entries.empty())
+    {
+        return npos;
+    }
+
+    const size_t mask = _slots.size() - 1;
+    for (size_t pos = static_cast<size_t>(hash) & mask;; pos = (pos + 1) & mask)
+    {
+        const uint32_t slot = _slots[pos];
+        if (slot == 0)
+        {
+            return npos;
+        }
+
+        const Entry &entry = _entries[slot - 1];
+        if (entry.hash == hash &&
+            IniHash::equal(text(entry.key, entry.key_length), key, _fold) &&
+            IniHash::equal(section_name(entry.section), section, _fold))
+        {
+            return slot - 1;
+        }
+    }
+}
+
+/**
+ * @brief Finds a section index, or npos.
+ */
+size_t IniTable::find_section(std::string_view section) const
+{
+    if (_sections.empty())
+    {
+        return npos;
+    }
+
+    const uint64_t hash = IniHash::section(section, _fold);
+    const size_t mask = _section_slots.size() - 1;
+    for (size_t pos = static_cast<size_t>(hash) & mask;; pos = (pos + 1) & mask)
+    {
+        const uint32_t slot = _section_slots[pos];
+        if (slot == 0)
+        {
+            return npos;
+        }
+        if (_sections[slot - 1].hash == hash && IniHash::equal(section_name(slot - 1), section, _fold))
+        {
+            return slot - 1;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether a section exists.
+ * @param section The section name.
+ * @return True if the section was added and not erased.
+ */
+bool IniTable::has_section(std::string_view section) const
+{
+    return find_section(section) != npos;
+}
+
+/**
+ * @brief Adds a section without any entries.
+ * @param section The section name.
+ */
+void IniTable::add_section(std::string_view section)
+{
+    intern_section(section);
+}
+
+/**
+ * @brief Finds or adds a section and returns its index.
+ */
+uint32_t IniTable::intern_section(std::string_view section)
+{
+    size_t found = find_section(section);
+    if (found != npos)
+    {
+        return static_cast<uint32_t>(found);
+    }
+    if (section.size() >= none)
+    {
+        throw std::runtime_error("Ini section name too long.");
+    }
+
+    const uint64_t hash = IniHash::section(section, _fold);
+    const size_t name = store(section);
+    _sections.push_back(Section{hash, name, static_cast<uint32_t>(section.size()), none, none});
+    if (2 * _sections.size() > _section_slots.size())
+    {
+        rehash(_entries.size(), _sections.size());
+    }
+    else
+    {
+        place(_section_slots, hash, _sections.size() - 1);
+    }
+    return static_cast<uint32_t>(_sections.size() - 1);
+}
+
+/**
+ * @brief Inserts an entry or overwrites its value.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value The value; may point into this table.
+ * @param line Line number to record, or npos to keep the existing one.
+ * @return The entry index.
+ */
+size_t IniTable::set(std::string_view section, std::string_view key, std::string_view value, size_t line)
+{
+    return set(hash(section, key), section, key, value, line);
+}
+
+/**
+ * @brief Inserts or overwrites an entry with a precomputed hash.
+ * @param hash hash() of section and key.
+ * @param section The section name.
+ * @param key The key name.
+ * @param value The value; may point into this table.
+ * @param line Line number to record, or npos to keep the existing one.
+ * @return The entry index.
+ */
+size_t IniTable::set(uint64_t hash, std::string_view section, std::string_view key, std::string_view value, size_t line)
+{
+    return insert(hash, section, key, value, line, false);
+}
+
+/**
+ * @brief Inserts an entry or overwrites its value, without copying.
+ * @details Used by the parser: the entry points at the key and value bytes
+ *          in the attached source, which must outlive it.
+ * @param section The section name.
+ * @param key The key name, inside the attached source.
+ * @param value The value, inside the attached source.
+ * @param line Line number to record, or npos to keep the existing one.
+ * @return The entry index.
+ */
+size_t IniTable::refer(std::string_view section, std::string_view key, std::string_view value, size_t line)
+{
+    return insert(hash(section, key), section, key, value, line, true);
+}
+
+/**
+ * @brief Inserts or overwrites an entry.
+ * @details Arguments may come from this table's own views; any inside the
+ *          arena are copied first, since storing may reallocate it.
+ * @param share True to refer to key and value bytes that lie inside the
+ *              attached source instead of copying them.
+ */
+size_t IniTable::insert(uint64_t hash, std::string_view section, std::string_view key, std::string_view value,
+                        size_t line, bool share)
+{
+    // Names and values read back from this table move when the arena grows
+    if (in_arena(section) || in_arena(key) || in_arena(value))
+    {
+        const std::string copy = std::string(section).append(key).append(value);
+        const std::string_view bytes(copy);
+        return insert(hash, bytes.substr(0, section.size()), bytes.substr(section.size(), key.size()),
+                      bytes.substr(section.size() + key.size()), line, share);
+    }
+
+    if (key.size() >= none || value.size() >= none)
+    {
+        throw std::runtime_error("Ini key or value too long.");
+    }
+
+    size_t index = find(hash, section, key);
+    if (index != npos)
+    {
+        // A shared duplicate takes over the key bytes too, so both sit on
+        // the recorded line and move together on reload
+        Entry &entry = _entries[index];
+        const size_t shared = share ? source_offset(key) : npos;
+        if (shared != npos)
+        {
+            _garbage += (entry.key & in_source) ? 0 : entry.key_length;
+            entry.key = shared;
+        }
+        assign(index, value, line, share);
+        return index;
+    }
+
+    if (_entries.size() + 1 >= none)
+    {
+        throw std::runtime_error("Too many keys in ini data.");
+    }
+
+    const uint32_t owner = intern_section(section);
+    index = _entries.size();
+    _in_order = _in_order && line >= _last_line;
+    _last_line = std::max(_last_line, line);
+    const size_t key_offset = keep(key, share);
+    const size_t value_offset = keep(value, share);
+    _entries.push_back(Entry{hash, key_offset, value_offset, static_cast<uint32_t>(key.size()),
+                             static_cast<uint32_t>(value.size()), owner, none, line, Typed{}});
+
+    Section &chain = _sections[owner];
+    if (chain.last == none)
+    {
+        chain.first = static_cast<uint32_t>(index);
+    }
+    else
+    {
+        _entries[chain.last].next = static_cast<uint32_t>(index);
+    }
+    chain.last = static_cast<uint32_t>(index);
+
+    if (2 * _entries.size() > _slots.size())
+    {
+        rehash(_entries.size(), _sections.size());
+    }
+    else
+    {
+        place(_slots, hash, index);
+    }
+    return index;
+}
+
+/**
+ * @brief Overwrites the value of an existing entry.
+ * @param entry The entry index.
+ * @param value The value; may point into this table.
+ * @param line Line number to record, or npos to keep the existing one.
+ */
+void IniTable::set_value(size_t entry, std::string_view value, size_t line)
+{
+    assign(entry, value, line, false);
+}
+
+/**
+ * @brief Overwrites the value of an entry.
+ * @details A value that fits in the old one's arena bytes is written in
+ *          place; otherwise it is appended, or referenced when shared, and
+ *          the old arena bytes become garbage. Source bytes are never written.
+ * @param share True to refer to value bytes inside the attached source.
+ */
+void IniTable::assign(size_t entry, std::string_view value, size_t line, bool share)
+{
+    if (value.size() >= none)
+    {
+        throw std::runtime_error("Ini key or value too long.");
+    }
+    if (in_arena(value))
+    {
+        const std::string copy(value);
+        assign(entry, copy, line, share);
+        return;
+    }
+
+    Entry &target = _entries[entry];
+    const bool owned = (target.value & in_source) == 0;
+    const size_t shared = share ? source_offset(value) : npos;
+    if (shared != npos)
+    {
+        _garbage += owned ? target.value_length : 0;
+        target.value = shared;
+    }
+    else if (owned && value.size() <= target.value_length)
+    {
+        if (!value.empty())
+        {
+            std::memcpy(&_arena[target.value], value.data(), value.size());
+        }
+        _garbage += target.value_length - value.size();
+    }
+    else
+    {
+        _garbage += owned ? target.value_length : 0;
+        target.value = store(value);
+    }
+    target.value_length = static_cast<uint32_t>(value.size());
+    target.typed.kind = Typed::none;
+    if (line != npos && line != target.line)
+    {
+        // A later duplicate moves the entry down the file
+        target.line = line;
+        _in_order = false;
+    }
+
+    if (_garbage > min_garbage && _garbage > _arena.size() / 2)
+    {
+        compact();
+    }
+}
+
+/**
+ * @brief Copies all entries of another table, overwriting duplicates.
+ * @details Sections are added first, in the other table's order, so that
+ *          section order still follows the file. Stored hashes are reused,
+ *          and bytes inside this table's source are referenced, not copied.
+ * @param other The table to merge; entries are applied in its order.
+ */
+void IniTable::merge(const IniTable &other)
+{
+    if (other._fold != _fold)
+    {
+        throw std::runtime_error("Cannot merge ini tables that fold case differently.");
+    }
+    reserve(_entries.size() + other._entries.size(), _arena.size() + other._arena.size());
+    for (size_t i = 0; i < other._sections.size(); ++i)
+    {
+        intern_section(other.section_name(i));
+    }
+    for (size_t i = 0; i < other._entries.size(); ++i)
+    {
+        const Entry &entry = other._entries[i];
+        insert(entry.hash, other.section(i), other.key(i), other.value(i), entry.line, true);
+    }
+}
+
+/**
+ * @brief Removes sections and all of their entries.
+ * @details Rebuilds the table from what remains into scratch, which also
+ *          compacts the arena, then swaps the two. Cached typed values are
+ *          carried over. Entry and section indices change.
+ * @param sections The section names.
+ * @param scratch Table whose buffers are reused for the rebuild; it is left
+ *                holding the old buffers for next time.
+ */
+void IniTable::erase_sections(const std::vector<std::string> &sections, IniTable &scratch)
+{
+    std::vector<bool> erased(_sections.size(), false);
+    bool any = false;
+    for (const std::string &name : sections)
+    {
+        size_t found = find_section(name);
+        if (found != npos)
+        {
+            erased[found] = true;
+            any = true;
+        }
+    }
+    if (!any)
+    {
+        return;
+    }
+
+    scratch.clear();
+    scratch._fold = _fold;
+    scratch.attach(_source);
+    scratch.reserve(_entries.size(), _arena.size() - _garbage);
+    for (size_t i = 0; i < _sections.size(); ++i)
+    {
+        if (!erased[i])
+        {
+            scratch.intern_section(section_name(i));
+        }
+    }
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        const Entry &entry = _entries[i];
+        if (!erased[entry.section])
+        {
+            const size_t index = scratch.insert(entry.hash, section(i), key(i), value(i), entry.line, true);
+            scratch._entries[index].typed = entry.typed;
+        }
+    }
+    std::swap(*this, scratch);
+}
+
+/**
+ * @brief Checks whether entries are stored in line order.
+ */
+bool IniTable::in_line_order() const
+{
+    return _in_order;
+}
+
+/**
+ * @brief Reorders entries and sections by line number.
+ * @details Rebuilds the table into scratch in stable line order, entries
+ *          without a line last, then swaps the two. Does nothing if the
+ *          entries are already in order.
+ * @param scratch Table whose buffers are reused for the rebuild; it is left
+ *                holding the old buffers for next time.
+ */
+void IniTable::sort_by_line(IniTable &scratch)
+{
+    if (_in_order)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> order(_entries.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+                     { return _entries[a].line < _entries[b].line; });
+
+    scratch.clear();
+    scratch._fold = _fold;
+    scratch.attach(_source);
+    scratch.reserve(_entries.size(), _arena.size() - _garbage);
+    for (uint32_t i : order)
+    {
+        const Entry &entry = _entries[i];
+        const size_t index = scratch.insert(entry.hash, section(i), key(i), value(i), entry.line, true);
+        scratch._entries[index].typed = entry.typed;
+    }
+    for (size_t i = 0; i < _sections.size(); ++i)
+    {
+        if (_sections[i].first == none)
+        {
+            scratch.intern_section(section_name(i));
+        }
+    }
+    std::swap(*this, scratch);
+}
+
+/**
+ * @brief Returns the section name of an entry.
+ */
+std::string_view IniTable::section(size_t entry) const
+{
+    return section_name(_entries[entry].section);
+}
+
+/**
+ * @brief Returns the key of an entry.
+ */
+std::string_view IniTable::key(size_t entry) const
+{
+    return text(_entries[entry].key, _entries[entry].key_length);
+}
+
+/**
+ * @brief Returns the value of an entry.
+ */
+std::string_view IniTable::value(size_t entry) const
+{
+    return text(_entries[entry].value, _entries[entry].value_length);
+}
+
+/**
+ * @brief Returns the cached parsed value of an entry.
+ */
+IniTable::Typed &IniTable::typed(size_t entry)
+{
+    return _entries[entry].typed;
+}
+
+/**
+ * @brief Returns the line number of an entry, or npos.
+ */
+size_t IniTable::line(size_t entry) const
+{
+    return _entries[entry].line;
+}
+
+/**
+ * @brief Moves an entry whose source block moved.
+ * @details Attach the new source before reading the entry again; arena
+ *          bytes are not affected.
+ * @param entry The entry index.
+ * @param line The new line number.
+ * @param shift Bytes by which the block moved in the new source.
+ */
+void IniTable::relocate(size_t entry, size_t line, std::ptrdiff_t shift)
+{
+    Entry &target = _entries[entry];
+    _in_order = _in_order && line == target.line;
+    target.line = line;
+    if (target.key & in_source)
+    {
+        target.key += static_cast<size_t>(shift);
+    }
+    if (target.value & in_source)
+    {
+        target.value += static_cast<size_t>(shift);
+    }
+}
+
+/**
+ * @brief Points an entry at an identical copy of its key and value.
+ * @details Used after the source is rewritten, so the entry stops holding
+ *          its own copy; arena bytes it held become garbage.
+ * @param entry The entry index.
+ * @param key Offset of the key in the attached source.
+ * @param value Offset of the value in the attached source.
+ */
+void IniTable::rebind(size_t entry, size_t key, size_t value)
+{
+    Entry &target = _entries[entry];
+    _garbage += (target.key & in_source) ? 0 : target.key_length;
+    _garbage += (target.value & in_source) ? 0 : target.value_length;
+    target.key = key | in_source;
+    target.value = value | in_source;
+}
+
+/**
+ * @brief Returns the name of the section with the given index.
+ */
+std::string_view IniTable::section_name(size_t index) const
+{
+    return std::string_view(_arena.data() + _sections[index].name, _sections[index].name_length);
+}
+
+/**
+ * @brief Returns the first entry of a section, in insertion order.
+ */
+size_t IniTable::section_first(size_t index) const
+{
+    return (_sections[index].first == none) ? npos : _sections[index].first;
+}
+
+/**
+ * @brief Returns the first entry of a section, in insertion order.
+ */
+size_t IniTable::section_first(std::string_view section) const
+{
+    size_t index = find_section(section);
+    return (index == npos) ? npos : section_first(index);
+}
+
+/**
+ * @brief Returns the entry after another in the same section.
+ */
+size_t IniTable::next_in_section(size_t entry) const
+{
+    return (_entries[entry].next == none) ? npos : _entries[entry].next;
+}
+
+/**
+ * @brief Adds the table's heap blocks to a tally.
+ */
+void IniTable::memory_usage(IniMemoryUsage &usage) const
+{
+    usage.add(_arena);
+    usage.add(_entries);
+    usage.add(_slots);
+    usage.add(_sections);
+    usage.add(_section_slots);
+}
+
+/**
+ * @brief Returns the memory attributable to one section.
+ */
+IniSectionMemory IniTable::section_memory(size_t index) const
+{
+    const Section &section = _sections[index];
+    IniSectionMemory memory;
+    memory.name = section_name(index);
+    memory.bytes = sizeof(Section) + section.name_length;
+    for (size_t i = section_first(index); i != npos; i = next_in_section(i))
+    {
+        const Entry &entry = _entries[i];
+        ++memory.entries;
+        memory.bytes += sizeof(Entry);
+        size_t &key_bytes = (entry.key & in_source) ? memory.source_bytes : memory.bytes;
+        key_bytes += entry.key_length;
+        size_t &value_bytes = (entry.value & in_source) ? memory.source_bytes : memory.bytes;
+        value_bytes += entry.value_length;
+    }
+    if (!_entries.empty())
+    {
+        memory.bytes += memory.entries * _slots.size() * sizeof(uint32_t) / _entries.size();
+    }
+    return memory;
+}
+
+/**
+ * @brief Returns the bytes at an arena or source offset.
+ */
+std::string_view IniTable::text(size_t offset, uint32_t length) const
+{
+    const char *base = (offset & in_source) ? _source.data() : _arena.data();
+    return std::string_view(base + (offset & ~in_source), length);
+}
+
+/**
+ * @brief Returns the flagged offset of bytes inside the source, or npos.
+ */
+size_t IniTable::source_offset(std::string_view bytes) const
+{
+    const std::less_equal<const char *> before;
+    if (_source.empty() || !before(_source.data(), bytes.data()) ||
+        !before(bytes.data() + bytes.size(), _source.data() + _source.size()))
+    {
+        return npos;
+    }
+    return static_cast<size_t>(bytes.data() - _source.data()) | in_source;
+}
+
+/**
+ * @brief True if bytes lie inside the arena, which moves when it grows.
+ */
+bool IniTable::in_arena(std::string_view bytes) const
+{
+    const std::less_equal<const char *> before;
+    return !bytes.empty() && !_arena.empty() && before(_arena.data(), bytes.data()) &&
+           before(bytes.data() + bytes.size(), _arena.data() + _arena.size());
+}
+
+/**
+ * @brief Returns a flagged source offset if share allows, else stores the bytes.
+ */
+size_t IniTable::keep(std::string_view bytes, bool share)
+{
+    const size_t shared = share ? source_offset(bytes) : npos;
+    return (shared != npos) ? shared : store(bytes);
+}
+
+/**
+ * @brief Appends bytes to the arena and returns their offset.
+ */
+size_t IniTable::store(std::string_view bytes)
+{
+    const size_t offset = _arena.size();
+    _arena.append(bytes.data(), bytes.size());
+    return offset;
+}
+
+/**
+ * @brief Rebuilds both slot arrays with room for the given counts.
+ */
+void IniTable::rehash(size_t entries, size_t sections)
+{
+    _slots.assign(slot_count(entries), 0);
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        place(_slots, _entries[i].hash, i);
+    }
+
+    _section_slots.assign(slot_count(sections), 0);
+    for (size_t i = 0; i < _sections.size(); ++i)
+    {
+        place(_section_slots, _sections[i].hash, i);
+    }
+}
+
+/**
+ * @brief Copies live strings into a fresh arena.
+ * @details Indices and hashes are unchanged; only arena offsets move.
+ */
+void IniTable::compact()
+{
+    std::string arena;
+    arena.reserve(_arena.size() - _garbage);
+    auto move_bytes = [&](size_t &offset, size_t length)
+    {
+        if (offset & in_source)
+        {
+            return;
+        }
+        const size_t moved = arena.size();
+        arena.append(_arena, offset, length);
+        offset = moved;
+    };
+
+    for (Section &section : _sections)
+    {
+        move_bytes(section.name, section.name_length);
+    }
+    for (Entry &entry : _entries)
+    {
+        move_bytes(entry.key, entry.key_length);
+        move_bytes(entry.value, entry.value_length);
+    }
+
+    _arena.swap(arena);
+    _garbage = 0;
+}
@@ -0,0 +1,444 @@
+/**
+ * @file ini_table.hpp
+ * @brief Flat open-addressing store for parsed INI values.
+ * @details Refers to keys and values in the loaded source text, keeps
+ *          section names and edited values in one contiguous arena, and finds
+ *          entries through a single hash of the section/key pair.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_TABLE_HPP
+#define INI_TABLE_HPP
+
+#include "ini_memory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class IniTable
+ * @brief Section/key/value store with one hash probe per lookup.
+ * @details Entries live in a vector in insertion order and are found through
+ *          a power-of-two slot array, probed linearly from IniHash::key() of
+ *          the section and key, case-folded if fold_case() is set; the array
+ *          is kept at most half full. Entries
+ *          store their hash, so strings are only compared on a hash match.
+ *          Entries added with refer() point into the attached source text
+ *          rather than copying it; everything else, including section names,
+ *          is appended to a single arena. The entries of each section are
+ *          chained so a section can be walked without scanning the whole
+ *          table.
+ *
+ *          Overwriting a value appends the new bytes and leaves the old ones
+ *          as garbage; the arena is compacted once garbage outweighs live
+ *          data. Entry indices stay valid until erase_sections() or clear();
+ *          compaction only moves bytes.
+ */
+class IniTable
+{
+public:
+    /**
+     * @brief Marker for a missing entry or an unknown line number.
+     */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Parsed form of a value, cached beside it by the typed getters.
+     * @details Cleared whenever the value text changes.
+     */
+    struct Typed
+    {
+        /**
+         * @brief Which member of the union is valid.
+         */
+        enum Kind : uint8_t
+        {
+            none,
+            int_value,
+            double_value,
+            bool_value
+        };
+
+        Kind kind; ///< Kind of the cached value.
+        union
+        {
+            int64_t as_int;   ///< Valid for int_value.
+            double as_double; ///< Valid for double_value.
+            bool as_bool;     ///< Valid for bool_value.
+        };
+    };
+
+    /**
+     * @brief Number of entries.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Number of sections, including ones that hold no entries.
+     */
+    size_t section_count() const;
+
+    /**
+     * @brief Removes everything, keeping the buffers for reuse.
+     * @details Also detaches the source text.
+     */
+    void clear();
+
+    /**
+     * @brief Sets the text that refer() entries point into.
+     * @param source The text; it must outlive every entry that refers to it.
+     */
+    void attach(std::string_view source);
+
+    /**
+     * @brief Makes section and key names match regardless of ASCII case.
+     * @details Hashes are folded as they are computed, so a lookup is still
+     *          one hash and one probe. The first spelling added is the one
+     *          kept.
+     * @param fold True to ignore case.
+     * @throws std::runtime_error if the table is not empty.
+     */
+    void fold_case(bool fold);
+
+    /**
+     * @brief Checks whether names are matched regardless of ASCII case.
+     */
+    bool folds_case() const;
+
+    /**
+     * @brief Hashes a section and key the way this table does.
+     * @param section The section name.
+     * @param key The key name.
+     * @return IniHash::key() of the pair, folded if the table folds case.
+     */
+    uint64_t hash(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Pre-sizes the table.
+     * @param entries Expected number of entries.
+     * @param bytes Expected arena size in bytes.
+     */
+    void reserve(size_t entries, size_t bytes);
+
+    /**
+     * @brief Finds an entry.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The entry index, or npos.
+     */
+    size_t find(std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Finds an entry by its precomputed hash.
+     * @param hash hash() of section and key.
+     * @param section The section name.
+     * @param key The key name.
+     * @return The entry index, or npos.
+     */
+    size_t find(uint64_t hash, std::string_view section, std::string_view key) const;
+
+    /**
+     * @brief Checks whether a section exists.
+     * @param section The section name.
+     * @return True if the section was added and not erased.
+     */
+    bool has_section(std::string_view section) const;
+
+    /**
+     * @brief Adds a section without any entries.
+     * @param section The section name.
+     */
+    void add_section(std::string_view section);
+
+    /**
+     * @brief Inserts an entry or overwrites its value.
+     * @param section The section name.
+     * @param key The key name.
+     * @param value The value.
+     * @param line Line number to record, or npos to keep the existing one.
+     * @return The entry index.
+     */
+    size_t set(std::string_view section, std::string_view key, std::string_view value, size_t line = npos);
+
+    /**
+     * @brief Inserts an entry or overwrites its value, with a precomputed hash.
+     * @param hash hash() of section and key.
+     * @param section The section name.
+     * @param key The key name.
+     * @param value The value.
+     * @param line Line number to record, or npos to keep the existing one.
+     * @return The entry index.
+     */
+    size_t set(uint64_t hash, std::string_view section, std::string_view key, std::string_view value, size_t line = npos);
+
+    /**
+     * @brief Inserts an entry or overwrites its value, without copying.
+     * @param section The section name.
+     * @param key The key name, inside the attached source.
+     * @param value The value, inside the attached source.
+     * @param line Line number to record, or npos to keep the existing one.
+     * @return The entry index.
+     */
+    size_t refer(std::string_view section, std::string_view key, std::string_view value, size_t line);
+
+    /**
+     * @brief Overwrites the value of an existing entry.
+     * @param entry The entry index.
+     * @param value The value.
+     * @param line Line number to record, or npos to keep the existing one.
+     */
+    void set_value(size_t entry, std::string_view value, size_t line = npos);
+
+    /**
+     * @brief Copies all entries of another table, overwriting duplicates.
+     * @param other The table to merge, folding case the same way; entries
+     *              are applied in its order.
+     */
+    void merge(const IniTable &other);
+
+    /**
+     * @brief Removes sections and all of their entries.
+     * @param sections The section names.
+     * @param scratch Table whose buffers are reused for the rebuild; it is
+     *                left holding the old buffers for next time.
+     */
+    void erase_sections(const std::vector<std::string> &sections, IniTable &scratch);
+
+    /**
+     * @brief Checks whether entries are stored in line order.
+     * @details Entries added with a line number, then those without, in the
+     *          order they were added. Loads keep this order; reloads, lazy
+     *          parsing and duplicate keys can break it.
+     */
+    bool in_line_order() const;
+
+    /**
+     * @brief Reorders entries and sections by line number.
+     * @details Sections follow their first entry; sections without entries
+     *          go last. Cached typed values are carried over. Entry and
+     *          section indices change unless the table is already in order.
+     * @param scratch Table whose buffers are reused for the rebuild; it is
+     *                left holding the old buffers for next time.
+     */
+    void sort_by_line(IniTable &scratch);
+
+    /**
+     * @brief Returns the section name of an entry.
+     */
+    std::string_view section(size_t entry) const;
+
+    /**
+     * @brief Returns the key of an entry.
+     */
+    std::string_view key(size_t entry) const;
+
+    /**
+     * @brief Returns the value of an entry.
+     */
+    std::string_view value(size_t entry) const;
+
+    /**
+     * @brief Returns the cached parsed value of an entry.
+     * @details The cache belongs to the caller: the table only clears it when
+     *          the value changes.
+     */
+    Typed &typed(size_t entry);
+
+    /**
+     * @brief Returns the line number of an entry, or npos.
+     */
+    size_t line(size_t entry) const;
+
+    /**
+     * @brief Moves an entry whose source block moved.
+     * @param entry The entry index.
+     * @param line The new line number.
+     * @param shift Bytes by which the block moved in the new source.
+     */
+    void relocate(size_t entry, size_t line, std::ptrdiff_t shift);
+
+    /**
+     * @brief Points an entry at an identical copy of its key and value.
+     * @param entry The entry index.
+     * @param key Offset of the key in the attached source.
+     * @param value Offset of the value in the attached source.
+     */
+    void rebind(size_t entry, size_t key, size_t value);
+
+    /**
+     * @brief Returns the name of the section with the given index.
+     * @param index Section index, less than section_count().
+     */
+    std::string_view section_name(size_t index) const;
+
+    /**
+     * @brief Returns the first entry of a section, in insertion order.
+     * @param index Section index, less than section_count().
+     * @return The entry index, or npos if the section is empty.
+     */
+    size_t section_first(size_t index) const;
+
+    /**
+     * @brief Returns the first entry of a section, in insertion order.
+     * @param section The section name.
+     * @return The entry index, or npos if the section is empty or missing.
+     */
+    size_t section_first(std::string_view section) const;
+
+    /**
+     * @brief Returns the entry after another in the same section.
+     * @return The entry index, or npos after the last one.
+     */
+    size_t next_in_section(size_t entry) const;
+
+    /**
+     * @brief Adds the table's heap blocks to a tally.
+     * @param usage The tally to add to.
+     */
+    void memory_usage(IniMemoryUsage &usage) const;
+
+    /**
+     * @brief Returns the memory attributable to one section.
+     * @details The slot array is shared by all entries and is divided
+     *          evenly between them; unused capacity and garbage left by
+     *          overwritten values belong to no section.
+     * @param index Section index, below section_count().
+     * @return Entry count, heap bytes and bytes read in place.
+     */
+    IniSectionMemory section_memory(size_t index) const;
+
+private:
+    /**
+     * @brief One key/value pair.
+     */
+    struct Entry
+    {
+        uint64_t hash;         ///< hash() of section and key.
+        size_t key;            ///< Arena or source offset of the key.
+        size_t value;          ///< Arena or source offset of the value.
+        uint32_t key_length;   ///< Length of the key.
+        uint32_t value_length; ///< Length of the value.
+        uint32_t section;      ///< Index of the owning section.
+        uint32_t next;         ///< Next entry of the section, or none.
+        size_t line;           ///< Line number in the source, or npos.
+        Typed typed;           ///< Parsed value, or Typed::none.
+    };
+
+    /**
+     * @brief One section and the chain of its entries.
+     */
+    struct Section
+    {
+        uint64_t hash;         ///< IniHash::section() of the name, folded like hash().
+        size_t name;           ///< Arena offset of the name.
+        uint32_t name_length;  ///< Length of the name.
+        uint32_t first;        ///< First entry, or none.
+        uint32_t last;         ///< Last entry, or none.
+    };
+
+    /**
+     * @brief Chain terminator for Entry::next and Section::first/last.
+     */
+    static constexpr uint32_t none = static_cast<uint32_t>(-1);
+
+    /**
+     * @brief Offset flag marking bytes in the source rather than the arena.
+     */
+    static constexpr size_t in_source = ~(npos >> 1);
+
+    /**
+     * @brief Finds a section index, or npos.
+     */
+    size_t find_section(std::string_view section) const;
+
+    /**
+     * @brief Finds or adds a section and returns its index.
+     */
+    uint32_t intern_section(std::string_view section);
+
+    /**
+     * @brief Inserts or overwrites an entry.
+     * @param share True to refer to value bytes inside the source.
+     */
+    size_t insert(uint64_t hash, std::string_view section, std::string_view key, std::string_view value,
+                  size_t line, bool share);
+
+    /**
+     * @brief Overwrites the value of an entry.
+     * @param share True to refer to value bytes inside the source.
+     */
+    void assign(size_t entry, std::string_view value, size_t line, bool share);
+
+    /**
+     * @brief Returns the bytes at an arena or source offset.
+     */
+    std::string_view text(size_t offset, uint32_t length) const;
+
+    /**
+     * @brief Returns the flagged offset of bytes inside the source, or npos.
+     */
+    size_t source_offset(std::string_view bytes) const;
+
+    /**
+     * @brief True if bytes lie inside the arena, which moves when it grows.
+     */
+    bool in_arena(std::string_view bytes) const;
+
+    /**
+     * @brief Returns a flagged source offset if share allows, else stores the bytes.
+     */
+    size_t keep(std::string_view bytes, bool share);
+
+    /**
+     * @brief Appends bytes to the arena and returns their offset.
+     */
+    size_t store(std::string_view bytes);
+
+    /**
+     * @brief Rebuilds both slot arrays with room for the given counts.
+     */
+    void rehash(size_t entries, size_t sections);
+
+    /**
+     * @brief Copies live strings into a fresh arena.
+     */
+    void compact();
+
+    std::string_view _source;             ///< Text that refer() entries point into.
+    std::string _arena;                   ///< Names and copied keys and values.
+    std::vector<Entry> _entries;          ///< Entries in insertion order.
+    std::vector<uint32_t> _slots;         ///< Entry index + 1 per slot; 0 is empty.
+    std::vector<Section> _sections;       ///< Sections in insertion order.
+    std::vector<uint32_t> _section_slots; ///< Section index + 1 per slot; 0 is empty.
+    size_t _garbage = 0;                  ///< Arena bytes no longer referenced.
+    bool _fold = false;                   ///< True to ignore ASCII case in names.
+    bool _in_order = true;                ///< True while entries are in line order.
+    size_t _last_line = 0;                ///< Highest line added so far; npos after an unnumbered entry.
+};
+
+#endif // INI_TABLE_HPP
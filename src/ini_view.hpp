@@ -0,0 +1,589 @@
+/**
+ * @file ini_view.hpp
+ * @brief Zero-copy views over parsed INI sections and entries.
+ * @details Ranges returned by IniFile::sections(), keys() and entries()
+ *          that walk the key table in file order and hand out string views
+ *          into it rather than copies.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2023-2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INI_VIEW_HPP
+#define INI_VIEW_HPP
+
+#include "ini_table.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct IniEntry
+ * @brief One key/value pair as seen by a view.
+ * @details The strings point into the IniFile and stay valid until it is
+ *          next changed or loaded. In thread-safe mode they point into a
+ *          copy held by the view they came from, and live as long as it.
+ */
+struct IniEntry
+{
+    std::string_view section; ///< Section name.
+    std::string_view key;     ///< Key name.
+    std::string_view value;   ///< Value text.
+    size_t line;              ///< Zero-based line in the file, or IniTable::npos if set in memory.
+};
+
+/**
+ * @class IniSectionView
+ * @brief Range of section names in file order.
+ * @details Sections created in memory follow those read from the file.
+ */
+class IniSectionView
+{
+public:
+    /**
+     * @brief Forward iterator yielding section names.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Iterator category.
+        using value_type = std::string_view;                 ///< Section name.
+        using difference_type = std::ptrdiff_t;              ///< Index difference.
+        using pointer = void;                                ///< Not addressable.
+        using reference = std::string_view;                  ///< Returned by value.
+
+        /**
+         * @brief Constructs an iterator at a section index.
+         */
+        iterator(const IniTable *table, size_t index) : _table(table), _index(index) {}
+
+        /**
+         * @brief Returns the section name.
+         */
+        std::string_view operator*() const { return _table->section_name(_index); }
+
+        /**
+         * @brief Advances to the next section.
+         */
+        iterator &operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        /**
+         * @brief Advances to the next section, returning the old position.
+         */
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++_index;
+            return old;
+        }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator==(const iterator &other) const { return _index == other._index; }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator!=(const iterator &other) const { return _index != other._index; }
+
+    private:
+        const IniTable *_table; ///< Table being walked.
+        size_t _index;          ///< Current section index.
+    };
+
+    /**
+     * @brief Constructs a view over the sections of a table.
+     */
+    explicit IniSectionView(const IniTable &table) : _table(&table) {}
+
+    /**
+     * @brief Constructs a view over the sections of a copy it keeps alive.
+     */
+    explicit IniSectionView(std::shared_ptr<const IniTable> copy) : _table(copy.get()), _copy(std::move(copy)) {}
+
+    /**
+     * @brief Returns an iterator at the first section.
+     */
+    iterator begin() const { return iterator(_table, 0); }
+
+    /**
+     * @brief Returns an iterator past the last section.
+     */
+    iterator end() const { return iterator(_table, _table->section_count()); }
+
+    /**
+     * @brief Number of sections.
+     */
+    size_t size() const { return _table->section_count(); }
+
+    /**
+     * @brief True if there are no sections.
+     */
+    bool empty() const { return _table->section_count() == 0; }
+
+private:
+    const IniTable *_table;                ///< Table being viewed.
+    std::shared_ptr<const IniTable> _copy; ///< Owned copy being viewed, if any.
+};
+
+/**
+ * @class IniKeyView
+ * @brief Range of the entries of one section in file order.
+ * @details Follows the section's chain through the table, so walking a
+ *          section never touches the entries of other sections.
+ */
+class IniKeyView
+{
+public:
+    /**
+     * @brief Forward iterator yielding entries.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Iterator category.
+        using value_type = IniEntry;                         ///< Entry of the section.
+        using difference_type = std::ptrdiff_t;              ///< Index difference.
+        using pointer = void;                                ///< Not addressable.
+        using reference = IniEntry;                          ///< Returned by value.
+
+        /**
+         * @brief Constructs an iterator at an entry index, or IniTable::npos.
+         */
+        iterator(const IniTable *table, size_t entry) : _table(table), _entry(entry) {}
+
+        /**
+         * @brief Returns the entry.
+         */
+        IniEntry operator*() const
+        {
+            return IniEntry{_table->section(_entry), _table->key(_entry), _table->value(_entry), _table->line(_entry)};
+        }
+
+        /**
+         * @brief Advances to the next entry of the section.
+         */
+        iterator &operator++()
+        {
+            _entry = _table->next_in_section(_entry);
+            return *this;
+        }
+
+        /**
+         * @brief Advances to the next entry, returning the old position.
+         */
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator==(const iterator &other) const { return _entry == other._entry; }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator!=(const iterator &other) const { return _entry != other._entry; }
+
+    private:
+        const IniTable *_table; ///< Table being walked.
+        size_t _entry;          ///< Current entry index, or IniTable::npos.
+    };
+
+    /**
+     * @brief Constructs a view starting at the first entry of a section.
+     * @param table The table.
+     * @param first The first entry, or IniTable::npos for an empty view.
+     */
+    IniKeyView(const IniTable &table, size_t first) : _table(&table), _first(first) {}
+
+    /**
+     * @brief Constructs a view over a section of a copy it keeps alive.
+     * @param copy The table.
+     * @param first The first entry, or IniTable::npos for an empty view.
+     */
+    IniKeyView(std::shared_ptr<const IniTable> copy, size_t first) : _table(copy.get()), _copy(std::move(copy)), _first(first) {}
+
+    /**
+     * @brief Returns an iterator at the first entry.
+     */
+    iterator begin() const { return iterator(_table, _first); }
+
+    /**
+     * @brief Returns an iterator past the last entry.
+     */
+    iterator end() const { return iterator(_table, IniTable::npos); }
+
+    /**
+     * @brief True if the section has no entries.
+     */
+    bool empty() const { return _first == IniTable::npos; }
+
+private:
+    const IniTable *_table;                ///< Table being viewed.
+    std::shared_ptr<const IniTable> _copy; ///< Owned copy being viewed, if any.
+    size_t _first;                         ///< First entry, or IniTable::npos.
+};
+
+/**
+ * @class IniEntryView
+ * @brief Range of every entry in file order.
+ * @details A linear pass over the table's contiguous entry array; sections
+ *          follow one another as in the file.
+ */
+class IniEntryView
+{
+public:
+    /**
+     * @brief Forward iterator yielding entries.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Iterator category.
+        using value_type = IniEntry;                         ///< Entry of the table.
+        using difference_type = std::ptrdiff_t;              ///< Index difference.
+        using pointer = void;                                ///< Not addressable.
+        using reference = IniEntry;                          ///< Returned by value.
+
+        /**
+         * @brief Constructs an iterator at an entry index.
+         */
+        iterator(const IniTable *table, size_t index) : _table(table), _index(index) {}
+
+        /**
+         * @brief Returns the entry.
+         */
+        IniEntry operator*() const
+        {
+            return IniEntry{_table->section(_index), _table->key(_index), _table->value(_index), _table->line(_index)};
+        }
+
+        /**
+         * @brief Advances to the next entry.
+         */
+        iterator &operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        /**
+         * @brief Advances to the next entry, returning the old position.
+         */
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++_index;
+            return old;
+        }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator==(const iterator &other) const { return _index == other._index; }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator!=(const iterator &other) const { return _index != other._index; }
+
+    private:
+        const IniTable *_table; ///< Table being walked.
+        size_t _index;          ///< Current entry index.
+    };
+
+    /**
+     * @brief Constructs a view over the entries of a table.
+     */
+    explicit IniEntryView(const IniTable &table) : _table(&table) {}
+
+    /**
+     * @brief Constructs a view over the entries of a copy it keeps alive.
+     */
+    explicit IniEntryView(std::shared_ptr<const IniTable> copy) : _table(copy.get()), _copy(std::move(copy)) {}
+
+    /**
+     * @brief Returns an iterator at the first entry.
+     */
+    iterator begin() const { return iterator(_table, 0); }
+
+    /**
+     * @brief Returns an iterator past the last entry.
+     */
+    iterator end() const { return iterator(_table, _table->size()); }
+
+    /**
+     * @brief Number of entries.
+     */
+    size_t size() const { return _table->size(); }
+
+    /**
+     * @brief True if there are no entries.
+     */
+    bool empty() const { return _table->size() == 0; }
+
+private:
+    const IniTable *_table;                ///< Table being viewed.
+    std::shared_ptr<const IniTable> _copy; ///< Owned copy being viewed, if any.
+};
+
+/**
+ * @class IniSectionMatchView
+ * @brief Sections found by a query, in file order.
+ */
+class IniSectionMatchView
+{
+public:
+    /**
+     * @brief Forward iterator yielding section names.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Iterator category.
+        using value_type = std::string_view;                 ///< Section name.
+        using difference_type = std::ptrdiff_t;              ///< Index difference.
+        using pointer = void;                                ///< Not addressable.
+        using reference = std::string_view;                  ///< Returned by value.
+
+        /**
+         * @brief Constructs an iterator at a position in the match list.
+         */
+        iterator(const IniTable *table, std::vector<size_t>::const_iterator match) : _table(table), _match(match) {}
+
+        /**
+         * @brief Returns the section name.
+         */
+        std::string_view operator*() const { return _table->section_name(*_match); }
+
+        /**
+         * @brief Advances to the next match.
+         */
+        iterator &operator++()
+        {
+            ++_match;
+            return *this;
+        }
+
+        /**
+         * @brief Advances to the next match, returning the old position.
+         */
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++_match;
+            return old;
+        }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator==(const iterator &other) const { return _match == other._match; }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator!=(const iterator &other) const { return _match != other._match; }
+
+    private:
+        const IniTable *_table;                     ///< Table the matches index.
+        std::vector<size_t>::const_iterator _match; ///< Current section index.
+    };
+
+    /**
+     * @brief Constructs a view over matching sections of a table.
+     * @param table The table.
+     * @param matches Section indices in file order.
+     */
+    IniSectionMatchView(const IniTable &table, std::vector<size_t> matches) : _table(&table), _matches(std::move(matches)) {}
+
+    /**
+     * @brief Constructs a view over matching sections of a copy it keeps alive.
+     * @param copy The table.
+     * @param matches Section indices in file order.
+     */
+    IniSectionMatchView(std::shared_ptr<const IniTable> copy, std::vector<size_t> matches)
+        : _table(copy.get()), _copy(std::move(copy)), _matches(std::move(matches)) {}
+
+    /**
+     * @brief Returns an iterator at the first match.
+     */
+    iterator begin() const { return iterator(_table, _matches.begin()); }
+
+    /**
+     * @brief Returns an iterator past the last match.
+     */
+    iterator end() const { return iterator(_table, _matches.end()); }
+
+    /**
+     * @brief Returns the name of a match.
+     */
+    std::string_view operator[](size_t index) const { return _table->section_name(_matches[index]); }
+
+    /**
+     * @brief Number of matches.
+     */
+    size_t size() const { return _matches.size(); }
+
+    /**
+     * @brief True if nothing matched.
+     */
+    bool empty() const { return _matches.empty(); }
+
+private:
+    const IniTable *_table;                ///< Table the matches index.
+    std::shared_ptr<const IniTable> _copy; ///< Owned copy being viewed, if any.
+    std::vector<size_t> _matches;          ///< Section indices in file order.
+};
+
+/**
+ * @class IniEntryMatchView
+ * @brief Entries found by a query, in file order.
+ */
+class IniEntryMatchView
+{
+public:
+    /**
+     * @brief Forward iterator yielding entries.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Iterator category.
+        using value_type = IniEntry;                         ///< Matching entry.
+        using difference_type = std::ptrdiff_t;              ///< Index difference.
+        using pointer = void;                                ///< Not addressable.
+        using reference = IniEntry;                          ///< Returned by value.
+
+        /**
+         * @brief Constructs an iterator at a position in the match list.
+         */
+        iterator(const IniTable *table, std::vector<size_t>::const_iterator match) : _table(table), _match(match) {}
+
+        /**
+         * @brief Returns the entry.
+         */
+        IniEntry operator*() const
+        {
+            return IniEntry{_table->section(*_match), _table->key(*_match), _table->value(*_match), _table->line(*_match)};
+        }
+
+        /**
+         * @brief Advances to the next match.
+         */
+        iterator &operator++()
+        {
+            ++_match;
+            return *this;
+        }
+
+        /**
+         * @brief Advances to the next match, returning the old position.
+         */
+        iterator operator++(int)
+        {
+            iterator old = *this;
+            ++_match;
+            return old;
+        }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator==(const iterator &other) const { return _match == other._match; }
+
+        /**
+         * @brief Compares positions.
+         */
+        bool operator!=(const iterator &other) const { return _match != other._match; }
+
+    private:
+        const IniTable *_table;                     ///< Table the matches index.
+        std::vector<size_t>::const_iterator _match; ///< Current entry index.
+    };
+
+    /**
+     * @brief Constructs a view over matching entries of a table.
+     * @param table The table.
+     * @param matches Entry indices in file order.
+     */
+    IniEntryMatchView(const IniTable &table, std::vector<size_t> matches) : _table(&table), _matches(std::move(matches)) {}
+
+    /**
+     * @brief Constructs a view over matching entries of a copy it keeps alive.
+     * @param copy The table.
+     * @param matches Entry indices in file order.
+     */
+    IniEntryMatchView(std::shared_ptr<const IniTable> copy, std::vector<size_t> matches)
+        : _table(copy.get()), _copy(std::move(copy)), _matches(std::move(matches)) {}
+
+    /**
+     * @brief Returns an iterator at the first match.
+     */
+    iterator begin() const { return iterator(_table, _matches.begin()); }
+
+    /**
+     * @brief Returns an iterator past the last match.
+     */
+    iterator end() const { return iterator(_table, _matches.end()); }
+
+    /**
+     * @brief Returns a match.
+     */
+    IniEntry operator[](size_t index) const
+    {
+        const size_t entry = _matches[index];
+        return IniEntry{_table->section(entry), _table->key(entry), _table->value(entry), _table->line(entry)};
+    }
+
+    /**
+     * @brief Number of matches.
+     */
+    size_t size() const { return _matches.size(); }
+
+    /**
+     * @brief True if nothing matched.
+     */
+    bool empty() const { return _matches.empty(); }
+
+private:
+    const IniTable *_table;                ///< Table the matches index.
+    std::shared_ptr<const IniTable> _copy; ///< Owned copy being viewed, if any.
+    std::vector<size_t> _matches;          ///< Entry indices in file order.
+};
+
+#endif // INI_VIEW_HPP
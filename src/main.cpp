@@ -30,11 +30,1318 @@
  */
 
 #include "ini_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <malloc.h>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 //std::string filename = "../test/test.ini";
 std::string filename = "/usr/local/etc/wsprrypi.ini";
 
+// Global heap allocation counter and live heap bytes used by the benchmarks;
+// atomic because the threaded tests allocate from several threads at once
+static std::atomic<size_t> allocations{0};
+static std::atomic<size_t> heap_bytes{0};
+
+// GCC flags free() on memory from operator new once these are inlined into
+// standard containers, but here both sides are malloc/free
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        heap_bytes += malloc_usable_size(ptr);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    heap_bytes -= malloc_usable_size(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    heap_bytes -= malloc_usable_size(ptr);
+    std::free(ptr);
+}
+
+#pragma GCC diagnostic pop
+
+// Writes a generated INI file with the given number of sections and keys
+size_t write_bench_file(const std::string &path, size_t sections, size_t keys)
+{
+    std::ofstream out(path);
+    size_t lines = 0;
+    for (size_t s = 0; s < sections; ++s)
+    {
+        out << "; Generated section " << s << "\n[Section " << s << "]\n";
+        lines += 2;
+        for (size_t k = 0; k < keys; ++k)
+        {
+            out << "; Setting " << k << " of section " << s << "\n";
+            out << "Setting Number " << k << " = value-" << s << "-" << k << " ; note\n";
+            lines += 2;
+        }
+    }
+    return lines;
+}
+
+void test_load_allocations(IniFile &config)
+{
+    std::cout << std::endl << "⏱️ Benchmarking load() allocations:" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    const size_t sections = 200;
+    const size_t keys = 50;
+    size_t lines = write_bench_file(bench_file, sections, keys);
+
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    config.set_filename(bench_file);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t count = allocations - before;
+
+    std::cout << "Lines parsed: " << lines << std::endl;
+    std::cout << "Heap allocations: " << count << " ("
+              << static_cast<double>(count) / static_cast<double>(lines) << " per line, "
+              << static_cast<double>(count) / static_cast<double>(sections * keys)
+              << " per stored key)" << std::endl;
+    std::cout << "Load time: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() << " us" << std::endl;
+
+    // A second load reuses the buffers of the first
+    before = allocations;
+    config.load();
+    std::cout << "Heap allocations on repeat load: " << allocations - before << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_memory_report(IniFile &config)
+{
+    std::cout << std::endl << "📏 Memory held after load() of 100k keys:" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_memory.ini";
+    const size_t sections = 1000;
+    const size_t keys = 100;
+    size_t lines = write_bench_file(bench_file, sections, keys);
+
+    // Key and value bytes that a copying store would hold a second time
+    size_t text_bytes = 0;
+    for (size_t s = 0; s < sections; ++s)
+    {
+        for (size_t k = 0; k < keys; ++k)
+        {
+            text_bytes += ("Setting Number " + std::to_string(k)).size() +
+                          ("value-" + std::to_string(s) + "-" + std::to_string(k)).size();
+        }
+    }
+
+    std::ifstream in(bench_file, std::ios::binary | std::ios::ate);
+    const size_t file_bytes = static_cast<size_t>(in.tellg());
+    in.close();
+
+    // Usable bytes as operator new sees them: the total less chunk headers
+    auto usable = [](const IniMemoryUsage &usage)
+    { return usage.total() - usage.allocations * sizeof(size_t); };
+
+    size_t before = heap_bytes;
+    size_t counted_before = usable(config.memory_stats().total());
+    config.set_filename(bench_file);
+    size_t held = heap_bytes - before;
+    const IniMemoryStats stats = config.memory_stats();
+    size_t counted = usable(stats.total()) - counted_before;
+
+    std::cout << "Lines: " << lines << ", keys: " << sections * keys << std::endl;
+    std::cout << "File size (read once into the heap): " << file_bytes << " bytes" << std::endl;
+    std::cout << "Heap held by lines, entries and index: " << held << " bytes ("
+              << static_cast<double>(held) / static_cast<double>(sections * keys) << " per key)" << std::endl;
+    std::cout << "Key and value bytes referenced in place: " << text_bytes << " bytes" << std::endl;
+
+    auto report = [](const char *name, const IniMemoryUsage &usage)
+    {
+        std::cout << name << usage.bytes << " bytes + " << usage.overhead << " overhead in "
+                  << usage.allocations << " allocations" << std::endl;
+    };
+    report("memory_stats() lines: ", stats.lines);
+    report("memory_stats() data:  ", stats.data);
+    report("memory_stats() index: ", stats.index);
+    report("memory_stats() other: ", stats.other);
+    std::cout << "memory_stats() mapped: " << stats.mapped << " bytes" << std::endl;
+    const IniSectionMemory &first = stats.sections.front();
+    std::cout << "memory_stats() [" << first.name << "]: " << first.entries << " keys, " << first.bytes
+              << " heap bytes, " << first.source_bytes << " bytes in place" << std::endl;
+    std::cout << (counted == held ? "✅" : "❌") << " memory_stats() growth matches operator new: " << counted
+              << " bytes" << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_snapshot(IniFile &config)
+{
+    std::cout << std::endl << "⏱️ Benchmarking load_snapshot():" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    const std::string snapshot_file = "/tmp/ini_file_bench.inib";
+    write_bench_file(bench_file, 200, 50);
+
+    auto start = std::chrono::steady_clock::now();
+    config.set_filename(bench_file);
+    auto parsed = std::chrono::steady_clock::now() - start;
+    config.save_snapshot(snapshot_file);
+
+    start = std::chrono::steady_clock::now();
+    bool used = config.load_snapshot(bench_file, snapshot_file);
+    auto mapped = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Parse time: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(parsed).count() << " us" << std::endl;
+    std::cout << "Snapshot time: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(mapped).count() << " us"
+              << (used ? "" : " (stale, parsed instead)") << std::endl;
+    std::cout << "Section 7 | Setting Number 3: "
+              << config.get_string_value("Section 7", "Setting Number 3") << std::endl;
+
+    std::remove(bench_file.c_str());
+    std::remove(snapshot_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_lookup_benchmark(IniFile &config)
+{
+    std::cout << std::endl << "⏱️ Benchmarking key lookups:" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 200, 50);
+    config.set_filename(bench_file);
+
+    // The nested map layout used before the flat table, for comparison
+    std::map<std::string, std::unordered_map<std::string, std::string>> nested;
+    for (const IniEntry &entry : config.entries())
+    {
+        nested[std::string(entry.section)].emplace(entry.key, entry.value);
+    }
+
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (const auto &section : nested)
+    {
+        for (const auto &entry : section.second)
+        {
+            keys.emplace_back(section.first, entry.first);
+        }
+    }
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        std::swap(keys[i], keys[(i * 2654435761u) % keys.size()]);
+    }
+
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &key : keys)
+    {
+        std::string value = nested.find(key.first)->second.find(key.second)->second;
+        bytes += value.size();
+    }
+    auto before = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (const auto &key : keys)
+    {
+        bytes += config.get_string_value(key.first, key.second).size();
+    }
+    auto after = std::chrono::steady_clock::now() - start;
+
+    auto per_lookup = [&keys](std::chrono::steady_clock::duration elapsed)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+               static_cast<double>(keys.size());
+    };
+    std::cout << "Keys looked up: " << keys.size() << " (" << bytes << " bytes read)" << std::endl;
+    std::cout << "Nested maps: " << per_lookup(before) << " ns per lookup" << std::endl;
+    std::cout << "Flat table: " << per_lookup(after) << " ns per lookup" << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_lookup_allocations(IniFile &config)
+{
+    std::cout << std::endl << "⏱️ Counting get_value() allocations:" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 200, 50);
+    config.set_filename(bench_file);
+
+    const size_t hits = 10000;
+    size_t bytes = 0;
+    size_t before = allocations;
+    for (size_t i = 0; i < hits; ++i)
+    {
+        bytes += config.get_value("Section 7", "Setting Number 3").size();
+    }
+    size_t count = allocations - before;
+
+    // Returned values longer than the small-string buffer still need one copy
+    std::cout << "Hits: " << hits << " (" << bytes << " bytes read)" << std::endl;
+    std::cout << "Heap allocations: " << count << " ("
+              << static_cast<double>(count) / static_cast<double>(hits) << " per hit)" << std::endl;
+    std::cout << (count == 0 ? "✅" : "❌") << " No temporaries built for lookups." << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_frozen(IniFile &config)
+{
+    std::cout << std::endl << "⏱️ Benchmarking freeze():" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 200, 50);
+    config.set_filename(bench_file);
+
+    auto start = std::chrono::steady_clock::now();
+    const FrozenIni frozen = config.freeze();
+    auto built = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (const IniEntry &entry : config.entries())
+    {
+        keys.emplace_back(entry.section, entry.key);
+    }
+
+    size_t bytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto &key : keys)
+    {
+        bytes += config.get_value(key.first, key.second).size();
+    }
+    auto live = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (const auto &key : keys)
+    {
+        bytes += frozen.get_value(key.first, key.second).size();
+    }
+    auto fixed = std::chrono::steady_clock::now() - start;
+
+    auto per_lookup = [&keys](std::chrono::steady_clock::duration elapsed)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+               static_cast<double>(keys.size());
+    };
+    std::cout << "Frozen " << frozen.size() << " keys in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(built).count() << " us ("
+              << bytes << " bytes read)" << std::endl;
+    std::cout << "IniFile::get_value(): " << per_lookup(live) << " ns per lookup" << std::endl;
+    std::cout << "FrozenIni::get_value(): " << per_lookup(fixed) << " ns per lookup" << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+// Visitor that picks a single value out of a file and stops
+class KeyFinder : public IniVisitor
+{
+public:
+    KeyFinder(std::string section, std::string key)
+        : _section(std::move(section)), _key(std::move(key)) {}
+
+    bool on_key_value(std::string_view section, std::string_view key,
+                      std::string_view value, size_t line) override
+    {
+        if (section == _section && key == _key)
+        {
+            found = true;
+            result.assign(value);
+            line_num = line;
+            return false;
+        }
+        return true;
+    }
+
+    bool found = false;
+    std::string result;
+    size_t line_num = 0;
+
+private:
+    std::string _section;
+    std::string _key;
+};
+
+void test_case_insensitive(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing case-insensitive names on: " << filename << std::endl;
+
+    config.set_case_insensitive(true);
+    config.load();
+    std::cout << "✅ common   | grid square: " << config.get_string_value("common", "grid square") << std::endl;
+    std::cout << "✅ COMMON   | TX POWER: " << config.get_int_value("COMMON", "TX POWER") << std::endl;
+
+    // Lookup cost with mixed-case queries in both modes
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 200, 50);
+    const size_t rounds = 20;
+    for (bool fold : {false, true})
+    {
+        config.set_case_insensitive(fold);
+        config.set_filename(bench_file);
+
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            for (size_t s = 0; s < 200; ++s)
+            {
+                const std::string section = (fold ? "SECTION " : "Section ") + std::to_string(s);
+                for (size_t k = 0; k < 50; ++k)
+                {
+                    const std::string key = (fold ? "setting number " : "Setting Number ") + std::to_string(k);
+                    bytes += config.get_value(section, key).size();
+                }
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << (fold ? "Case-insensitive" : "Case-sensitive") << " get_value(): "
+                  << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                         static_cast<double>(rounds * 200 * 50)
+                  << " ns per lookup (" << bytes << " bytes read)" << std::endl;
+    }
+
+    std::remove(bench_file.c_str());
+    config.set_case_insensitive(false);
+    config.set_filename(filename);
+}
+
+void test_iteration(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing iteration in file order on: " << filename << std::endl;
+
+    for (std::string_view section : config.sections())
+    {
+        std::cout << "[" << section << "]" << std::endl;
+        for (const IniEntry &entry : config.keys(section))
+        {
+            std::cout << "  " << entry.key << " = " << entry.value << std::endl;
+        }
+    }
+
+    // Dumping every entry: nested copy vs one linear pass
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 1000, 100);
+    config.set_filename(bench_file);
+
+    size_t before = allocations;
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &section : config.getData())
+    {
+        for (const auto &entry : section.second)
+        {
+            bytes += section.first.size() + entry.first.size() + entry.second.size();
+        }
+    }
+    auto nested = std::chrono::steady_clock::now() - start;
+    size_t nested_allocations = allocations - before;
+
+    before = allocations;
+    start = std::chrono::steady_clock::now();
+    for (const IniEntry &entry : config.entries())
+    {
+        bytes += entry.section.size() + entry.key.size() + entry.value.size();
+    }
+    auto linear = std::chrono::steady_clock::now() - start;
+    size_t linear_allocations = allocations - before;
+
+    std::cout << "getData() dump of 100000 keys: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(nested).count() << " us, "
+              << nested_allocations << " allocations" << std::endl;
+    std::cout << "entries() dump of 100000 keys: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(linear).count() << " us, "
+              << linear_allocations << " allocations (" << bytes << " bytes read)" << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_queries(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing prefix and glob queries on: " << filename << std::endl;
+
+    for (const IniEntry &entry : config.find_keys("*", "LED*"))
+    {
+        std::cout << "✅ " << entry.section << " | " << entry.key << ": " << entry.value << std::endl;
+    }
+    for (std::string_view section : config.find_sections("S*"))
+    {
+        std::cout << "✅ Section matching S*: " << section << std::endl;
+    }
+
+    // Indexed queries against a full scan of 100k keys
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 1000, 100);
+    config.set_filename(bench_file);
+
+    auto micros = [](std::chrono::steady_clock::duration elapsed)
+    { return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(); };
+
+    auto start = std::chrono::steady_clock::now();
+    size_t found = config.find_keys("Section 99*").size();
+    auto first = std::chrono::steady_clock::now() - start;
+    std::cout << "First query, including index build: " << micros(first) << " us (" << found << " matches)" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    found = config.find_keys("Section 123").size();
+    found += config.find_keys("Section 12?", "Setting Number 5").size();
+    auto indexed = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    size_t scanned = 0;
+    for (const IniEntry &entry : config.entries())
+    {
+        scanned += (entry.section == "Section 123") ? 1 : 0;
+        scanned += (entry.section.size() == 11 && entry.section.substr(0, 10) == "Section 12" &&
+                    entry.key == "Setting Number 5")
+                       ? 1
+                       : 0;
+    }
+    auto scan = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Two indexed queries: " << micros(indexed) << " us (" << found << " matches)" << std::endl;
+    std::cout << "Full scan for the same two: " << micros(scan) << " us (" << scanned << " matches)" << std::endl;
+
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+// The settings test_reading() prints, described once for bind()
+struct WsprSettings
+{
+    bool transmit = false;
+    std::string call_sign;
+    std::string grid_square;
+    int tx_power = 0;
+    std::string frequency;
+    int transmit_pin = 0;
+    double ppm = 0.0;
+    bool use_ntp = false;
+    bool offset = false;
+    bool use_led = false;
+    int led_pin = 0;
+    int power_level = 0;
+    int web_port = 0;
+    int socket_port = 0;
+    bool use_shutdown = false;
+    int shutdown_button = 0;
+};
+
+template <>
+struct IniBinding<WsprSettings>
+{
+    static constexpr IniField<WsprSettings> fields[] = {
+        {"Control", "Transmit", &WsprSettings::transmit},
+        {"Common", "Call Sign", &WsprSettings::call_sign},
+        {"Common", "Grid Square", &WsprSettings::grid_square},
+        {"Common", "TX Power", &WsprSettings::tx_power},
+        {"Common", "Frequency", &WsprSettings::frequency},
+        {"Common", "Transmit Pin", &WsprSettings::transmit_pin},
+        {"Extended", "PPM", &WsprSettings::ppm},
+        {"Extended", "Use NTP", &WsprSettings::use_ntp},
+        {"Extended", "Offset", &WsprSettings::offset},
+        {"Extended", "Use LED", &WsprSettings::use_led},
+        {"Extended", "LED Pin", &WsprSettings::led_pin},
+        {"Extended", "Power Level", &WsprSettings::power_level},
+        {"Server", "Web Port", &WsprSettings::web_port},
+        {"Server", "Socket Port", &WsprSettings::socket_port},
+        {"Server", "Use Shutdown", &WsprSettings::use_shutdown},
+        {"Server", "Shutdown Button", &WsprSettings::shutdown_button},
+    };
+};
+
+// A table with broken entries, to show that errors are reported together
+struct BrokenSettings
+{
+    int call_sign = 0;
+    int missing_key = 0;
+    int missing_section = 0;
+};
+
+template <>
+struct IniBinding<BrokenSettings>
+{
+    static constexpr IniField<BrokenSettings> fields[] = {
+        {"Common", "Call Sign", &BrokenSettings::call_sign},
+        {"Common", "No Such Key", &BrokenSettings::missing_key},
+        {"No Such Section", "Key", &BrokenSettings::missing_section},
+    };
+};
+
+void test_binding(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing struct binding on: " << filename << std::endl;
+
+    WsprSettings settings;
+    bind(config, settings);
+    std::cout << "✅ Common   | Call Sign: " << settings.call_sign << std::endl;
+    std::cout << "✅ Common   | TX Power: " << settings.tx_power << std::endl;
+    std::cout << "✅ Extended | PPM: " << settings.ppm << std::endl;
+    std::cout << "✅ Server   | Web Port: " << settings.web_port << std::endl;
+
+    try
+    {
+        BrokenSettings broken;
+        bind(config, broken);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "⚠️ Caught Exception:" << std::endl << e.what() << std::endl;
+    }
+
+    // One bind() against the sixteen get_* calls of test_reading()
+    const size_t rounds = 100000;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        settings.transmit = config.get_bool_value("Control", "Transmit");
+        settings.call_sign = config.get_string_value("Common", "Call Sign");
+        settings.grid_square = config.get_string_value("Common", "Grid Square");
+        settings.tx_power = config.get_int_value("Common", "TX Power");
+        settings.frequency = config.get_string_value("Common", "Frequency");
+        settings.transmit_pin = config.get_int_value("Common", "Transmit Pin");
+        settings.ppm = config.get_double_value("Extended", "PPM");
+        settings.use_ntp = config.get_bool_value("Extended", "Use NTP");
+        settings.offset = config.get_bool_value("Extended", "Offset");
+        settings.use_led = config.get_bool_value("Extended", "Use LED");
+        settings.led_pin = config.get_int_value("Extended", "LED Pin");
+        settings.power_level = config.get_int_value("Extended", "Power Level");
+        settings.web_port = config.get_int_value("Server", "Web Port");
+        settings.socket_port = config.get_int_value("Server", "Socket Port");
+        settings.use_shutdown = config.get_bool_value("Server", "Use Shutdown");
+        settings.shutdown_button = config.get_int_value("Server", "Shutdown Button");
+    }
+    auto separate = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        bind(config, settings);
+    }
+    auto bound = std::chrono::steady_clock::now() - start;
+
+    auto per_round = [rounds](std::chrono::steady_clock::duration elapsed)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+               static_cast<double>(rounds);
+    };
+    std::cout << "Sixteen get_* calls: " << per_round(separate) << " ns per struct" << std::endl;
+    std::cout << "One bind(): " << per_round(bound) << " ns per struct" << std::endl;
+}
+
+// Keys of test_reading(), hashed at compile time
+constexpr IniKey<std::string> CallSign{"Common", "Call Sign"};
+constexpr IniKey<int> TxPower{"Common", "TX Power"};
+constexpr IniKey<double> Ppm{"Extended", "PPM"};
+constexpr IniKey<bool> UseNtp{"Extended", "Use NTP"};
+static_assert(TxPower.hash(false) == IniHash::key("Common", "TX Power"), "TxPower is hashed at compile time");
+
+void test_typed_keys(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing typed keys on: " << filename << std::endl;
+
+    std::cout << "✅ Common   | Call Sign: " << config.get(CallSign) << std::endl;
+    std::cout << "✅ Common   | TX Power: " << config.get(TxPower) << std::endl;
+    std::cout << "✅ Extended | PPM: " << config.get(Ppm) << std::endl;
+    std::cout << "✅ Extended | Use NTP: " << config.get(UseNtp) << std::endl;
+
+    // Typed keys against named lookups and handles
+    const size_t rounds = 1000000;
+    auto per_read = [rounds](std::chrono::steady_clock::duration elapsed)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+               static_cast<double>(rounds);
+    };
+
+    long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        sum += config.get_int_value("Common", "TX Power");
+    }
+    auto named = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        sum += config.get(TxPower);
+    }
+    auto typed = std::chrono::steady_clock::now() - start;
+
+    const KeyHandle handle = config.resolve("Common", "TX Power");
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        sum += config.get_int_value(handle);
+    }
+    auto handled = std::chrono::steady_clock::now() - start;
+
+    std::cout << "get_int_value(\"Common\", \"TX Power\"): " << per_read(named) << " ns per read" << std::endl;
+    std::cout << "get(TxPower): " << per_read(typed) << " ns per read" << std::endl;
+    std::cout << "get_int_value(handle): " << per_read(handled) << " ns per read (" << sum << ")" << std::endl;
+}
+
+void test_concurrent_reads(IniFile &config)
+{
+    std::cout << std::endl << "⏱️ Benchmarking concurrent reads in thread-safe mode:" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 200, 50);
+    config.set_thread_safe(true);
+    config.set_filename(bench_file);
+
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (size_t s = 0; s < 200; ++s)
+    {
+        for (size_t k = 0; k < 50; ++k)
+        {
+            keys.emplace_back("Section " + std::to_string(s), "Setting Number " + std::to_string(k));
+        }
+    }
+
+    const size_t reads_per_thread = 1000000;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    // The same reads on one thread without locking, as a baseline
+    config.set_thread_safe(false);
+    size_t unlocked_bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < reads_per_thread; ++i)
+    {
+        const auto &key = keys[(i * 2654435761u) % keys.size()];
+        unlocked_bytes += config.get_value(key.first, key.second).size();
+    }
+    std::cout << "1 reader without locking: "
+              << static_cast<double>(reads_per_thread) /
+                     std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 1e6
+              << " million reads/s (" << unlocked_bytes << " bytes read)" << std::endl;
+    config.set_thread_safe(true);
+
+    for (bool with_writer : {false, true})
+    {
+        for (size_t threads : {1, 2, 4, 8})
+        {
+            std::atomic<bool> done{false};
+            std::thread writer;
+            if (with_writer)
+            {
+                writer = std::thread([&config, &done]
+                                     {
+                                         for (int i = 0; !done; ++i)
+                                         {
+                                             config.set_int_value("Section 0", "Setting Number 0", i);
+                                             std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                         } });
+            }
+
+            std::vector<std::thread> readers;
+            std::atomic<size_t> bytes{0};
+            start = std::chrono::steady_clock::now();
+            for (size_t t = 0; t < threads; ++t)
+            {
+                readers.emplace_back([&config, &keys, &bytes, t, reads_per_thread]
+                                     {
+                                         size_t read = 0;
+                                         for (size_t i = 0; i < reads_per_thread; ++i)
+                                         {
+                                             const auto &key = keys[(i * 2654435761u + t) % keys.size()];
+                                             read += config.get_value(key.first, key.second).size();
+                                         }
+                                         bytes += read; });
+            }
+            for (std::thread &reader : readers)
+            {
+                reader.join();
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            done = true;
+            if (writer.joinable())
+            {
+                writer.join();
+            }
+
+            const double seconds = std::chrono::duration<double>(elapsed).count();
+            std::cout << threads << (threads == 1 ? " reader" : " readers") << (with_writer ? " and a writer" : "")
+                      << ": " << static_cast<double>(threads * reads_per_thread) / seconds / 1e6
+                      << " million reads/s (" << bytes << " bytes read)" << std::endl;
+        }
+    }
+
+    config.set_thread_safe(false);
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_concurrent_views(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing views while another thread writes:" << std::endl;
+
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 200, 50);
+    // Lazy sections are all parsed by each load in this mode, so reads share the lock
+    config.set_lazy_load(true);
+    config.set_thread_safe(true);
+    config.set_filename(bench_file);
+    config.load();
+
+    // Views keep their own copy, so a writer cannot pull entries out from under a walk
+    std::atomic<bool> done{false};
+    std::thread writer([&config, &done]
+                       {
+                           for (int i = 0; !done; ++i)
+                           {
+                               config.set_string_value("Section " + std::to_string(i % 200), "Setting Number 0", std::string(i % 64, 'x'));
+                               if (i % 10 == 0)
+                               {
+                                   config.reload();
+                               }
+                               std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                           } });
+
+    size_t walked = 0;
+    size_t found = 0;
+    bool complete = true;
+    for (int round = 0; round < 20; ++round)
+    {
+        size_t entries = 0;
+        for (std::string_view section : config.sections())
+        {
+            for (const IniEntry &entry : config.keys(section))
+            {
+                walked += entry.value.size();
+                ++entries;
+            }
+        }
+        complete = complete && entries == 200 * 50;
+        for (const IniEntry &entry : config.find_keys("Section 1?", "Setting Number 0"))
+        {
+            found += entry.key.size();
+        }
+    }
+    done = true;
+    writer.join();
+
+    std::cout << (complete ? "✅" : "❌") << " 20 walks of 10000 entries (" << walked << " value bytes, "
+              << found << " key bytes found)" << std::endl;
+
+    config.set_thread_safe(false);
+    config.set_lazy_load(false);
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_snapshots(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing published snapshots on: " << filename << std::endl;
+
+    std::shared_ptr<const ConfigSnapshot> before = config.snapshot();
+    config.set_int_value("Common", "TX Power", 27);
+    std::shared_ptr<const ConfigSnapshot> after = config.snapshot();
+    std::cout << "✅ Held snapshot | TX Power: " << before->get_int_value("Common", "TX Power") << std::endl;
+    std::cout << "✅ New snapshot  | TX Power: " << after->get_int_value("Common", "TX Power") << std::endl;
+    config.load();
+
+    // Worst read latency while another thread keeps loading 100k keys
+    const std::string bench_file = "/tmp/ini_file_bench.ini";
+    write_bench_file(bench_file, 1000, 100);
+    config.set_thread_safe(true);
+    config.set_filename(bench_file);
+
+    for (bool use_snapshot : {false, true})
+    {
+        std::atomic<bool> done{false};
+        std::thread writer([&config, &done]
+                           {
+                               while (!done)
+                               {
+                                   config.load();
+                               } });
+
+        std::chrono::steady_clock::duration worst{};
+        size_t bytes = 0;
+        const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (std::chrono::steady_clock::now() < until)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (use_snapshot)
+            {
+                bytes += config.snapshot()->get_value("Section 7", "Setting Number 3").size();
+            }
+            else
+            {
+                bytes += config.get_value("Section 7", "Setting Number 3").size();
+            }
+            worst = std::max(worst, std::chrono::steady_clock::now() - start);
+        }
+        done = true;
+        writer.join();
+
+        std::cout << (use_snapshot ? "snapshot()->get_value()" : "Locked get_value()") << " worst case during loads: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(worst).count() << " us (" << bytes
+                  << " bytes read)" << std::endl;
+    }
+
+    config.set_thread_safe(false);
+    std::remove(bench_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_parallel_load(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing a 4-thread load against a sequential one:" << std::endl;
+
+    // Every section name recurs through the file, so its keys, and the
+    // repeats of each key, land in different chunks
+    const std::string parallel_file = "/tmp/ini_file_parallel.ini";
+    {
+        std::ofstream out(parallel_file);
+        out << "; generated\nunnamed = first\nunnamed = last\n";
+        for (size_t block = 0; block < 4000; ++block)
+        {
+            out << "[Section " << block % 500 << "]\n";
+            for (size_t k = 0; k < 20; ++k)
+            {
+                out << "Key " << (block + k) % 25 << " = value " << block << "-" << k << "\n";
+            }
+        }
+    }
+    config.set_filename(parallel_file);
+
+    using Row = std::tuple<std::string, std::string, std::string, size_t>;
+    auto load_rows = [&config](unsigned threads)
+    {
+        config.set_load_threads(threads);
+        config.load();
+        std::vector<Row> rows;
+        for (const IniEntry &entry : config.entries())
+        {
+            rows.emplace_back(std::string(entry.section), std::string(entry.key), std::string(entry.value), entry.line);
+        }
+        return rows;
+    };
+    const std::vector<Row> sequential = load_rows(1);
+    const std::vector<Row> parallel = load_rows(4);
+    const std::string last = config.get_value("Section 499", "Key 18");
+    config.set_load_threads(1);
+
+    std::cout << (sequential == parallel ? "✅" : "❌") << " entries(): " << parallel.size() << " with 4 threads, "
+              << sequential.size() << " sequentially" << std::endl;
+    std::cout << (last == "value 3999-19" ? "✅" : "❌") << " Section 499 | Key 18: " << last << std::endl;
+
+    std::remove(parallel_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_load_sources(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing load() from text, a descriptor and a stream:" << std::endl;
+
+    // Larger than the 64 KiB first read, so a pipe needs several
+    std::string text = "; sources\n";
+    for (size_t s = 0; s < 100; ++s)
+    {
+        text += "[Section " + std::to_string(s) + "]\n";
+        for (size_t k = 0; k < 50; ++k)
+        {
+            text += "Setting Number " + std::to_string(k) + " = " + std::to_string(s * k) + "\n";
+        }
+    }
+
+    using Row = std::tuple<std::string, std::string, std::string, size_t>;
+    auto rows = [&config]
+    {
+        std::vector<Row> found;
+        for (const IniEntry &entry : config.entries())
+        {
+            found.emplace_back(std::string(entry.section), std::string(entry.key), std::string(entry.value), entry.line);
+        }
+        return found;
+    };
+
+    config.load(std::string_view(text));
+    const std::vector<Row> expected = rows();
+
+    // A descriptor is read from its current offset, so a prefix already consumed is skipped
+    const std::string prefix = "not ini data\n";
+    const std::string fd_file = "/tmp/ini_file_fd.ini";
+    {
+        std::ofstream out(fd_file, std::ios::binary);
+        out << prefix << text;
+    }
+    int fd = ::open(fd_file.c_str(), O_RDONLY);
+    ::lseek(fd, static_cast<off_t>(prefix.size()), SEEK_SET);
+    config.load(fd);
+    const bool from_offset = rows() == expected;
+    const bool at_end = ::lseek(fd, 0, SEEK_CUR) == static_cast<off_t>(prefix.size() + text.size());
+    ::close(fd);
+    std::remove(fd_file.c_str());
+
+    int ends[2];
+    bool from_pipe = false;
+    if (::pipe(ends) == 0)
+    {
+        std::thread writer([&text, &ends]
+                           {
+                               for (size_t done = 0; done < text.size();)
+                               {
+                                   const ssize_t n = ::write(ends[1], text.data() + done, text.size() - done);
+                                   if (n <= 0)
+                                   {
+                                       break;
+                                   }
+                                   done += static_cast<size_t>(n);
+                               }
+                               ::close(ends[1]); });
+        config.load(ends[0]);
+        writer.join();
+        ::close(ends[0]);
+        from_pipe = rows() == expected;
+    }
+
+    std::istringstream stream(text);
+    config.load(stream);
+    const bool from_stream = rows() == expected;
+
+    // Mapped: entries point into the file itself, reported as mapped bytes
+    const std::string map_file = "/tmp/ini_file_map.ini";
+    {
+        std::ofstream out(map_file, std::ios::binary);
+        out << text;
+    }
+    config.set_mmap_load(true);
+    fd = ::open(map_file.c_str(), O_RDONLY);
+    config.load(fd);
+    ::close(fd);
+    const bool from_map = rows() == expected && config.memory_stats().mapped == text.size();
+    config.set_mmap_load(false);
+    config.load(std::string_view(text));
+    std::remove(map_file.c_str());
+
+    std::cout << (from_offset && at_end ? "✅" : "❌") << " load(fd) at offset " << prefix.size()
+              << ": same " << expected.size() << " entries, descriptor left at end" << std::endl;
+    std::cout << (from_pipe ? "✅" : "❌") << " load(fd) from a pipe: same entries" << std::endl;
+    std::cout << (from_stream ? "✅" : "❌") << " load(std::istream&): same entries" << std::endl;
+    std::cout << (from_map ? "✅" : "❌") << " load(fd) with set_mmap_load(true): same entries, "
+              << text.size() << " bytes mapped" << std::endl;
+
+    config.load();
+}
+
+void test_key_handles(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing key handles across reload() and setData():" << std::endl;
+
+    const std::string handle_file = "/tmp/ini_file_handles.ini";
+    auto write = [&handle_file](const std::string &text)
+    {
+        std::ofstream out(handle_file, std::ios::trunc);
+        out << text;
+    };
+    write("[A]\nx = 1\n[B]\ny = 2\nz = 3\n");
+    config.set_filename(handle_file);
+    config.load();
+
+    const KeyHandle z = config.resolve("B", "z");
+    const std::string loaded = config.get_value(z);
+
+    // B is untouched but moves down a section: its entries are relocated
+    write("[New]\nw = 0\n[A]\nx = 1\n[B]\ny = 2\nz = 3\n");
+    config.reload();
+    const std::string moved = config.get_value(z);
+
+    // B itself changes, and z moves within it: the section is re-parsed
+    write("[New]\nw = 0\n[A]\nx = 1\n[B]\nz = 30\ny = 2\n");
+    config.reload();
+    const std::string reparsed = config.get_value(z);
+
+    config.setData({{"B", {{"z", "300"}}}});
+    const std::string replaced = config.get_value(z);
+    config.set_int_value(z, 7);
+    const std::string written = config.get_value("B", "z");
+
+    bool missing = false;
+    config.setData({{"A", {{"x", "1"}}}});
+    try
+    {
+        config.get_value(z);
+    }
+    catch (const std::runtime_error &)
+    {
+        missing = true;
+    }
+
+    const bool ok = loaded == "3" && moved == "3" && reparsed == "30" && replaced == "300" && written == "7" && missing;
+    std::cout << (ok ? "✅" : "❌") << " B | z: " << loaded << " after load, " << moved << " after moving, "
+              << reparsed << " after re-parsing, " << replaced << " after setData(), " << written
+              << " set through the handle, " << (missing ? "error" : "no error") << " once removed" << std::endl;
+
+    std::remove(handle_file.c_str());
+    config.set_filename(filename);
+    config.load();
+}
+
+void test_view_writeback(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing values written back from views:" << std::endl;
+
+    // Values set in memory live in the table's arena, which grows as more are written
+    config.load(std::string_view("[A]\nfile = from the file\n"));
+    for (size_t i = 0; i < 200; ++i)
+    {
+        config.set_string_value("A", "set " + std::to_string(i), "set in memory " + std::to_string(i));
+    }
+
+    std::vector<std::pair<std::string, std::string>> expected;
+    size_t i = 0;
+    for (const IniEntry &entry : config.entries())
+    {
+        if (i == 201)
+        {
+            break;
+        }
+        const std::string key = "copied from entry number " + std::to_string(i++);
+        expected.emplace_back(key, std::string(entry.value));
+        config.set_string_value(entry.section, key, entry.value);
+    }
+
+    // Overwrite in place from another entry's bytes
+    for (const IniEntry &entry : config.keys("A"))
+    {
+        if (entry.key == "set 3")
+        {
+            config.set_string_value("A", "set 2", entry.value);
+            break;
+        }
+    }
+
+    bool same = config.get_value("A", "set 2") == "set in memory 3";
+    for (const auto &copy : expected)
+    {
+        same = same && config.get_value("A", copy.first) == copy.second;
+    }
+    std::cout << (same ? "✅" : "❌") << " " << expected.size() << " values copied from entries() into new keys" << std::endl;
+
+    config.load();
+}
+
+void test_reload(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing reload() after switching lazy loading off:" << std::endl;
+
+    const std::string reload_file = "/tmp/ini_file_reload.ini";
+    auto write = [&reload_file](const char *text)
+    {
+        std::ofstream out(reload_file, std::ios::trunc);
+        out << text;
+    };
+
+    // Read only [A] lazily, so [B] is still pending when lazy mode goes off
+    write("[A]\nx = 1\n[B]\ny = 2\n");
+    config.set_lazy_load(true);
+    config.set_filename(reload_file);
+    config.get_value("A", "x");
+    config.set_lazy_load(false);
+
+    write("[Z]\nz = 0\n[A]\nx = 1\n[B]\ny = 2\n");
+    std::cout << "Changed sections:";
+    for (const std::string &section : config.reload())
+    {
+        std::cout << " [" << section << "]";
+    }
+    std::cout << std::endl;
+
+    try
+    {
+        size_t count = 0;
+        for (const IniEntry &entry : config.entries())
+        {
+            std::cout << "  [" << entry.section << "] " << entry.key << " = " << entry.value << " (line "
+                      << entry.line + 1 << ")" << std::endl;
+            ++count;
+        }
+        std::cout << (count == 3 && config.get_value("B", "y") == "2" ? "✅" : "❌")
+                  << " Unchanged pending section kept: B | y = " << config.get_value("B", "y") << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "❌ Caught Exception: " << e.what() << std::endl;
+    }
+
+    std::remove(reload_file.c_str());
+    config.set_filename(filename);
+}
+
+void test_external_rewrite(IniFile &config)
+{
+    std::cout << std::endl << "🔎 Testing reads after the file is rewritten on disk:" << std::endl;
+
+    // Load 2,000 keys, then have another writer truncate the file under us
+    const std::string rewrite_file = "/tmp/ini_file_rewrite.ini";
+    write_bench_file(rewrite_file, 1, 2000);
+    config.set_filename(rewrite_file);
+    {
+        std::ofstream out(rewrite_file, std::ios::trunc);
+        out << "[Section 0]\n";
+    }
+
+    const std::string value = config.get_value("Section 0", "Setting Number 1999");
+    std::cout << (value == "value-0-1999" ? "✅" : "❌") << " Value loaded before the rewrite: " << value << std::endl;
+
+    // Saving writes what was loaded, not what is on disk now
+    config.save();
+    config.load();
+    std::cout << (config.get_value("Section 0", "Setting Number 1999") == value ? "✅" : "❌")
+              << " Value kept through save() and load()" << std::endl;
+
+    std::remove(rewrite_file.c_str());
+    config.set_filename(filename);
+}
+
+// Splits text into lines one byte at a time, as IniScanner::next() should
+std::vector<IniScanner::Line> reference_lines(std::string_view text)
+{
+    const size_t npos = IniScanner::npos;
+    std::vector<IniScanner::Line> lines;
+    for (size_t pos = 0; pos < text.size();)
+    {
+        IniScanner::Line line{pos, npos, npos, npos, npos, npos};
+        size_t i = pos;
+        for (; i < text.size() && text[i] != '\n'; ++i)
+        {
+            const char c = text[i];
+            if (c != ' ' && c != '\t' && c != '\r')
+            {
+                line.first = (line.first == npos) ? i : line.first;
+                line.last = i;
+            }
+            if (c == '=' && line.equals == npos)
+            {
+                line.equals = i;
+            }
+            else if ((c == ';' || c == '#') && line.equals != npos && line.comment == npos)
+            {
+                line.comment = i;
+            }
+        }
+        line.end = i;
+        lines.push_back(line);
+        pos = (i < text.size()) ? i + 1 : i;
+    }
+    return lines;
+}
+
+void test_scanner()
+{
+    std::cout << std::endl << "🔎 Testing scanner classifiers against a byte-at-a-time reference:" << std::endl;
+
+    // Delimiter-heavy random text, with lines shorter and longer than a block
+    std::mt19937 random(12345);
+    const std::string alphabet = "\n\n=[];# \t\rab\x80\xff";
+    std::vector<std::string> texts = {"", "\n", "a", "[S]\nk = v ; c\n", std::string(64, '='), std::string(64, ' ') + "x"};
+    for (size_t length : {1, 63, 64, 65, 127, 128, 129, 1000, 4096})
+    {
+        for (int round = 0; round < 20; ++round)
+        {
+            std::string text;
+            for (size_t i = 0; i < length; ++i)
+            {
+                text += alphabet[random() % alphabet.size()];
+            }
+            texts.push_back(text);
+            texts.push_back(text + "\n");
+        }
+    }
+
+    const std::string selected = IniScanner::implementation();
+    for (const char *name : {"scalar", "sse2", "avx2"})
+    {
+        if (!IniScanner::use_implementation(name))
+        {
+            std::cout << "⚠️ " << name << ": not available here" << std::endl;
+            continue;
+        }
+
+        size_t lines = 0;
+        size_t mismatches = 0;
+        for (const std::string &text : texts)
+        {
+            const std::vector<IniScanner::Line> expected = reference_lines(text);
+            std::vector<IniScanner::Line> actual;
+            IniScanner scanner(text);
+            IniScanner::Line line;
+            while (scanner.next(line))
+            {
+                actual.push_back(line);
+            }
+
+            bool same = actual.size() == expected.size() && IniScanner::count_lines(text) == expected.size();
+            for (size_t i = 0; same && i < actual.size(); ++i)
+            {
+                const IniScanner::Line &a = actual[i];
+                const IniScanner::Line &e = expected[i];
+                same = a.begin == e.begin && a.end == e.end && a.first == e.first && a.last == e.last &&
+                       a.equals == e.equals && a.comment == e.comment;
+            }
+            lines += expected.size();
+            mismatches += same ? 0 : 1;
+        }
+        std::cout << (mismatches == 0 ? "✅ " : "❌ ") << name << ": " << texts.size() << " texts, "
+                  << lines << " lines, " << mismatches << " mismatched" << std::endl;
+    }
+    IniScanner::use_implementation("");
+    std::cout << "Default classifier restored: " << (selected == IniScanner::implementation() ? selected : "changed!") << std::endl;
+}
+
+void test_streaming()
+{
+    std::cout << std::endl << "🔎 Testing Streaming Parse: on:" << filename << std::endl;
+
+    KeyFinder finder("Common", "Grid Square");
+    bool complete = IniFile::parse(filename, finder);
+    if (finder.found)
+    {
+        std::cout << "✅ Common   | Grid Square: " << finder.result
+                  << " (line " << finder.line_num + 1 << ", stopped early: " << !complete << ")" << std::endl;
+    }
+    else
+    {
+        std::cerr << "⚠️ Grid Square not found." << std::endl;
+    }
+}
+
 void test_malformed_entries(IniFile &config)
 {
     std::cout << std::endl << "⚠️ Testing Malformed INI Entries:" << std::endl;
@@ -198,6 +1505,28 @@ int main()
     // test_writing(iniFile);
     // test_malformed_entries(ini);
     // test_exceptions(ini);
+    // test_load_allocations(iniFile);
+    // test_memory_report(iniFile);
+    // test_streaming();
+    // test_snapshot(iniFile);
+    // test_lookup_benchmark(iniFile);
+    // test_lookup_allocations(iniFile);
+    // test_frozen(iniFile);
+    // test_case_insensitive(iniFile);
+    // test_iteration(iniFile);
+    // test_queries(iniFile);
+    // test_binding(iniFile);
+    // test_typed_keys(iniFile);
+    // test_concurrent_reads(iniFile);
+    // test_concurrent_views(iniFile);
+    // test_snapshots(iniFile);
+    // test_external_rewrite(iniFile);
+    // test_reload(iniFile);
+    // test_scanner();
+    // test_parallel_load(iniFile);
+    // test_load_sources(iniFile);
+    // test_key_handles(iniFile);
+    // test_view_writeback(iniFile);
 
     return 0;
 }